@@ -0,0 +1,183 @@
+#include "animated_sprites.h"
+#include "gl_state.h"
+
+#include <algorithm>
+#include <cstddef>
+
+void AnimatedSpriteRenderer::init(GLuint textureArray, int maxSprites)
+{
+    this->texID = textureArray;
+    this->capacity = maxSprites;
+
+    shader = ShaderProgram::fromFiles("animated_sprite.vert", "texture_array.frag");
+    timeLoc = shader.uniform("time");
+    projectionLoc = shader.uniform("projection");
+    shader.use();
+    shader.setInt(shader.uniform("tex_buff"), 0);
+
+    // Cantos do quadrado unitário, na ordem do GL_TRIANGLE_STRIP de setupSprite
+    GLfloat corners[] = {
+        -0.5f, 0.5f,  // V0
+        -0.5f, -0.5f, // V1
+        0.5f, 0.5f,   // V2
+        0.5f, -0.5f   // V3
+    };
+
+    glGenVertexArrays(1, &VAO);
+    glstate::bindVertexArray(VAO);
+
+    glGenBuffers(1, &quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+
+    // Atributo 0 - Canto do quadrado, compartilhado por todas as instâncias
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Instance), NULL, GL_DYNAMIC_DRAW);
+
+    // Atributos 1 a 4 - Um valor por sprite (divisor 1): posição, tamanho, animação
+    // (inteiro) e instante de início
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid *)offsetof(Instance, x));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid *)offsetof(Instance, width));
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(Instance), (GLvoid *)offsetof(Instance, animation));
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid *)offsetof(Instance, startTime));
+    for (GLuint attribute = 1; attribute <= 4; attribute++)
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glstate::bindVertexArray(0);
+
+    instances.reserve(capacity);
+}
+
+void AnimatedSpriteRenderer::setProjection(const glm::mat4 &projection)
+{
+    shader.use();
+    shader.setMat4(projectionLoc, projection);
+}
+
+int AnimatedSpriteRenderer::addAnimation(int firstLayer, int frameCount, float fps, bool loop)
+{
+    if ((int)clips.size() >= MAX_ANIMATIONS)
+    {
+        return -1;
+    }
+    clips.push_back(glm::vec4((float)firstLayer, (float)std::max(frameCount, 1), fps, loop ? 1.0f : 0.0f));
+    clipsDirty = true;
+    return (int)clips.size() - 1;
+}
+
+int AnimatedSpriteRenderer::addRows(int nAnimations, int nFrames, float fps)
+{
+    int first = -1;
+    for (int row = 0; row < nAnimations; row++)
+    {
+        int id = addAnimation(row * nFrames, nFrames, fps);
+        first = row == 0 ? id : first;
+    }
+    return first;
+}
+
+int AnimatedSpriteRenderer::add(const glm::vec3 &position, const glm::vec2 &size, int animation, float startTime)
+{
+    // Um id fora da tabela faria o vertex shader ler clips[] fora do array
+    if ((int)instances.size() >= capacity || animation < 0 || animation >= (int)clips.size())
+    {
+        return -1;
+    }
+    Instance instance = {position.x, position.y, position.z, size.x, size.y, (GLuint)animation, startTime};
+    instances.push_back(instance);
+    markDirty((int)instances.size() - 1);
+    return (int)instances.size() - 1;
+}
+
+void AnimatedSpriteRenderer::setPosition(int sprite, const glm::vec3 &position)
+{
+    Instance &instance = instances[sprite];
+    instance.x = position.x;
+    instance.y = position.y;
+    instance.z = position.z;
+    markDirty(sprite);
+}
+
+void AnimatedSpriteRenderer::setAnimation(int sprite, int animation, float startTime)
+{
+    Instance &instance = instances[sprite];
+    if (animation < 0 || animation >= (int)clips.size() || instance.animation == (GLuint)animation)
+    {
+        return;
+    }
+    instance.animation = (GLuint)animation;
+    instance.startTime = startTime;
+    markDirty(sprite);
+}
+
+void AnimatedSpriteRenderer::setLayer(int sprite, int layer)
+{
+    // O bit alto marca, no mesmo atributo, uma camada fixa em vez de uma animação
+    Instance &instance = instances[sprite];
+    GLuint fixed = FIXED_LAYER | (GLuint)std::max(layer, 0);
+    if (instance.animation == fixed)
+    {
+        return;
+    }
+    instance.animation = fixed;
+    markDirty(sprite);
+}
+
+void AnimatedSpriteRenderer::markDirty(int sprite)
+{
+    dirtyFirst = dirtyFirst <= dirtyLast ? std::min(dirtyFirst, sprite) : sprite;
+    dirtyLast = std::max(dirtyLast, sprite);
+}
+
+void AnimatedSpriteRenderer::draw(float time)
+{
+    if (instances.empty())
+    {
+        return;
+    }
+
+    // Só o trecho alterado desde o último draw vai para a GPU
+    if (dirtyFirst <= dirtyLast)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, dirtyFirst * sizeof(Instance), (dirtyLast - dirtyFirst + 1) * sizeof(Instance),
+                        instances.data() + dirtyFirst);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        dirtyFirst = 0;
+        dirtyLast = -1;
+    }
+
+    shader.use();
+    // O array inteiro vai de uma vez, direto (o cache de uniforms só guarda o primeiro
+    // elemento); um programa novo (hot reload) também precisa receber a tabela
+    if ((clipsDirty || clipsProgram != shader.id()) && !clips.empty())
+    {
+        glUniform4fv(glGetUniformLocation(shader.id(), "clips"), (GLsizei)clips.size(), &clips[0][0]);
+        clipsDirty = false;
+        clipsProgram = shader.id();
+    }
+    shader.setFloat(timeLoc, time);
+
+    glstate::activeTexture(GL_TEXTURE0);
+    glstate::bindTexture(GL_TEXTURE_2D_ARRAY, texID);
+    glstate::bindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)instances.size());
+}
+
+void AnimatedSpriteRenderer::release()
+{
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteBuffers(1, &instanceVBO);
+    glDeleteVertexArrays(1, &VAO);
+    glstate::forgetVertexArray(VAO);
+    VAO = quadVBO = instanceVBO = 0;
+    instances.clear();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+// Sprites animados desenhados por instância, com o frame escolhido na GPU
+// A spritesheet vira uma GL_TEXTURE_2D_ARRAY (loadTextureArray), com um frame por
+// camada, e cada sprite guarda só posição, tamanho, animação e o instante em que a
+// animação começou. O vertex shader (shaders/animated_sprite.vert) calcula o frame
+// atual a partir do uniform time e da tabela de animações; nada é enviado por
+// frame além desse uniform, então mil sprites animados custam o mesmo na CPU que um
+// Posição e animação só vão para a GPU quando mudam (trecho alterado do buffer)
+// Um sprite também pode ter o frame escolhido na CPU (setLayer), ex.: por um
+// Animators, quando o jogo precisa dos eventos dos clips no frame que está na tela
+// Uso: init() com contexto OpenGL, addRows() ou addAnimation(), add() para cada
+// sprite e, a cada frame, draw(tempo)
+class AnimatedSpriteRenderer
+{
+public:
+    // Mesmo tamanho do array clips[] do shader
+    static const int MAX_ANIMATIONS = 64;
+
+    // textureArray vem de loadTextureArray; a textura continua sendo de quem chamou
+    void init(GLuint textureArray, int maxSprites = 1024);
+    void setProjection(const glm::mat4 &projection);
+
+    // Animação com frameCount camadas a partir de firstLayer, a fps quadros por
+    // segundo. Sem loop, para no último frame. Retorna o id da animação (-1 se a
+    // tabela está cheia)
+    int addAnimation(int firstLayer, int frameCount, float fps, bool loop = true);
+    // Uma animação por linha de uma spritesheet com nAnimations linhas e nFrames
+    // colunas, na ordem das linhas da imagem (de cima para baixo). Retorna o id da primeira
+    int addRows(int nAnimations, int nFrames, float fps);
+
+    // Novo sprite (centro e tamanho na tela); retorna o índice dele, ou -1 se está
+    // cheio ou a animação não existe
+    int add(const glm::vec3 &position, const glm::vec2 &size, int animation, float startTime);
+    void setPosition(int sprite, const glm::vec3 &position);
+    // Troca a animação, recomeçando do primeiro frame em startTime. Pedir a mesma
+    // animação de novo não reinicia (mantém o passo de uma caminhada, por exemplo).
+    // Um id que não existe é ignorado
+    void setAnimation(int sprite, int animation, float startTime);
+    // Mostra a camada layer do array, sem animar na GPU, até o próximo setAnimation
+    void setLayer(int sprite, int layer);
+
+    int count() const { return (int)instances.size(); }
+
+    // time na mesma escala dos startTime (ex.: glfwGetTime desde o início do jogo;
+    // como é float, convém um relógio que comece perto de zero)
+    void draw(float time);
+
+    // Libera os buffers (precisa do contexto OpenGL)
+    void release();
+
+    ShaderProgram &program() { return shader; }
+
+private:
+    // Bit de Instance::animation com uma camada fixa (setLayer) nos outros bits
+    static const GLuint FIXED_LAYER = 0x80000000u;
+
+    // Atributos de instância: 28 bytes por sprite
+    struct Instance
+    {
+        GLfloat x, y, z;
+        GLfloat width, height;
+        GLuint animation;
+        GLfloat startTime;
+    };
+
+    void markDirty(int sprite);
+
+    ShaderProgram shader;
+    int timeLoc = -1;
+    int projectionLoc = -1;
+    GLuint texID = 0;
+    GLuint VAO = 0, quadVBO = 0, instanceVBO = 0;
+    int capacity = 0;
+
+    std::vector<Instance> instances;
+    std::vector<glm::vec4> clips; // primeira camada, frames, fps, loop
+    bool clipsDirty = false;
+    GLuint clipsProgram = 0; // programa que recebeu a tabela por último
+    int dirtyFirst = 0, dirtyLast = -1;
+};
@@ -0,0 +1,252 @@
+#include "animation.h"
+#include "animated_sprites.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    // Bits de Animators::states
+    const uint8_t STARTED = 1 << 0;  // já passou por um update (o frame 0 já disparou eventos)
+    const uint8_t FINISHED = 1 << 1; // clip sem loop parado no último frame
+
+    bool parseError(const std::string &sourceName, int lineNumber, const std::string &message)
+    {
+        std::cout << sourceName << ":" << lineNumber << ": " << message << std::endl;
+        return false;
+    }
+
+    struct ParsedEvent
+    {
+        std::string clip;
+        AnimationEvent event;
+        int lineNumber;
+    };
+}
+
+std::string AnimationLibrary::sidecarPath(const std::string &imagePath)
+{
+    return std::filesystem::path(imagePath).replace_extension(".anim").string();
+}
+
+bool AnimationLibrary::load(const std::string &filePath)
+{
+    std::ifstream file(filePath);
+    if (!file)
+    {
+        std::cout << "Failed to open animation file " << filePath << std::endl;
+        return false;
+    }
+
+    sheetRows = sheetColumns = 1;
+    clips.clear();
+    events.clear();
+    std::vector<ParsedEvent> parsedEvents;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.erase(comment);
+        }
+        std::istringstream tokens(line);
+        std::string word;
+        if (!(tokens >> word))
+        {
+            continue;
+        }
+
+        if (word == "sheet")
+        {
+            if (!(tokens >> sheetRows >> sheetColumns) || sheetRows <= 0 || sheetColumns <= 0)
+            {
+                return parseError(filePath, lineNumber, "expected: sheet <rows> <columns>");
+            }
+        }
+        else if (word == "clip")
+        {
+            AnimationClip clip;
+            int lastFrame;
+            std::string mode;
+            if (!(tokens >> clip.name >> clip.firstFrame >> lastFrame >> clip.fps >> mode) ||
+                (mode != "loop" && mode != "once"))
+            {
+                return parseError(filePath, lineNumber, "expected: clip <name> <first> <last> <fps> loop|once");
+            }
+            if (clip.firstFrame < 0 || lastFrame < clip.firstFrame || lastFrame >= sheetRows * sheetColumns ||
+                clip.fps <= 0.0f)
+            {
+                return parseError(filePath, lineNumber, "clip '" + clip.name + "' is outside the sheet");
+            }
+            if (find(clip.name) >= 0)
+            {
+                return parseError(filePath, lineNumber, "duplicate clip '" + clip.name + "'");
+            }
+            clip.frameCount = lastFrame - clip.firstFrame + 1;
+            clip.loop = mode == "loop";
+            clips.push_back(clip);
+        }
+        else if (word == "event")
+        {
+            ParsedEvent parsed;
+            parsed.lineNumber = lineNumber;
+            if (!(tokens >> parsed.clip >> parsed.event.frame >> parsed.event.name))
+            {
+                return parseError(filePath, lineNumber, "expected: event <clip> <frame> <name>");
+            }
+            parsedEvents.push_back(parsed);
+        }
+        else
+        {
+            return parseError(filePath, lineNumber, "unknown keyword '" + word + "'");
+        }
+    }
+
+    // Eventos agrupados por clip (e em ordem de frame), para o update só olhar os do clip tocado
+    for (const ParsedEvent &parsed : parsedEvents)
+    {
+        int id = find(parsed.clip);
+        if (id < 0)
+        {
+            return parseError(filePath, parsed.lineNumber, "unknown clip '" + parsed.clip + "'");
+        }
+        if (parsed.event.frame < 0 || parsed.event.frame >= clips[id].frameCount)
+        {
+            return parseError(filePath, parsed.lineNumber, "event frame outside clip '" + parsed.clip + "'");
+        }
+    }
+    for (int id = 0; id < (int)clips.size(); id++)
+    {
+        clips[id].firstEvent = (int)events.size();
+        for (const ParsedEvent &parsed : parsedEvents)
+        {
+            if (parsed.clip == clips[id].name)
+            {
+                events.push_back(parsed.event);
+            }
+        }
+        clips[id].eventCount = (int)events.size() - clips[id].firstEvent;
+        std::sort(events.begin() + clips[id].firstEvent, events.end(),
+                  [](const AnimationEvent &a, const AnimationEvent &b) { return a.frame < b.frame; });
+    }
+
+    if (clips.empty())
+    {
+        return parseError(filePath, lineNumber, "no clips");
+    }
+    return true;
+}
+
+int AnimationLibrary::find(const std::string &name) const
+{
+    for (int id = 0; id < (int)clips.size(); id++)
+    {
+        if (clips[id].name == name)
+        {
+            return id;
+        }
+    }
+    return -1;
+}
+
+int AnimationLibrary::upload(AnimatedSpriteRenderer &renderer) const
+{
+    int first = -1;
+    for (int id = 0; id < (int)clips.size(); id++)
+    {
+        const AnimationClip &clip = clips[id];
+        int animation = renderer.addAnimation(clip.firstFrame, clip.frameCount, clip.fps, clip.loop);
+        if (animation < 0)
+        {
+            return -1;
+        }
+        first = id == 0 ? animation : first;
+    }
+    return first;
+}
+
+int Animators::create(int clip)
+{
+    clips.push_back((uint16_t)clip);
+    frames.push_back(0);
+    times.push_back(0.0f);
+    speeds.push_back(1.0f);
+    states.push_back(0);
+    return (int)clips.size() - 1;
+}
+
+void Animators::play(int animator, int clip, bool restart)
+{
+    if (clips[animator] == clip && !restart)
+    {
+        return;
+    }
+    clips[animator] = (uint16_t)clip;
+    frames[animator] = 0;
+    times[animator] = 0.0f;
+    states[animator] = 0;
+}
+
+bool Animators::finished(int animator) const
+{
+    return (states[animator] & FINISHED) != 0;
+}
+
+void Animators::update(float dt, std::vector<AnimationHit> *hits)
+{
+    int count = size();
+    for (int n = 0; n < count; n++)
+    {
+        if (states[n] & FINISHED)
+        {
+            continue;
+        }
+
+        const AnimationClip &clip = library->clip(clips[n]);
+        float time = times[n] + dt * speeds[n];
+        // Passos de frame desde o início (-1 antes do primeiro update: o frame 0 também dispara eventos)
+        int previous = (states[n] & STARTED) ? (int)(times[n] * clip.fps) : -1;
+        states[n] |= STARTED;
+        int current = (int)(time * clip.fps);
+        times[n] = time;
+        // Em loop, o tempo volta para a primeira volta: o float não perde precisão com as horas
+        if (clip.loop && current >= clip.frameCount)
+        {
+            int cycles = current / clip.frameCount;
+            times[n] -= cycles * clip.frameCount / clip.fps;
+            previous -= cycles * clip.frameCount;
+            current -= cycles * clip.frameCount;
+        }
+
+        if (!clip.loop && current >= clip.frameCount - 1)
+        {
+            current = clip.frameCount - 1;
+            states[n] |= FINISHED;
+        }
+        frames[n] = (uint16_t)(clip.loop ? current % clip.frameCount : current);
+
+        // Eventos dos frames alcançados neste passo (no máximo uma volta do clip)
+        if (!hits || clip.eventCount == 0 || current == previous)
+        {
+            continue;
+        }
+        for (int step = std::max(previous + 1, current - clip.frameCount + 1); step <= current; step++)
+        {
+            int frame = (step % clip.frameCount + clip.frameCount) % clip.frameCount;
+            for (int e = clip.firstEvent; e < clip.firstEvent + clip.eventCount; e++)
+            {
+                if (library->event(e).frame == frame)
+                {
+                    hits->push_back(AnimationHit{n, e});
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class AnimatedSpriteRenderer;
+
+// Animação de uma spritesheet: frames firstFrame .. firstFrame + frameCount - 1,
+// numerados linha a linha a partir do canto de cima à esquerda (a mesma ordem das
+// camadas de loadTextureArray)
+struct AnimationClip
+{
+    std::string name;
+    int firstFrame = 0;
+    int frameCount = 1;
+    float fps = 12.0f;
+    bool loop = true;
+    int firstEvent = 0; // eventos do clip em AnimationLibrary::event()
+    int eventCount = 0;
+};
+
+// Evento disparado quando a animação chega a um frame (ex.: "step" no pé no chão)
+struct AnimationEvent
+{
+    int frame = 0; // frame dentro do clip (0 = primeiro)
+    std::string name;
+};
+
+// Clips de uma spritesheet lidos de um arquivo ao lado da imagem (sidecarPath):
+//   sheet <linhas> <colunas>
+//   clip <nome> <primeiro frame> <último frame> <fps> loop|once
+//   event <clip> <frame do clip> <nome>
+// Linhas vazias e o que vem depois de # são ignorados
+class AnimationLibrary
+{
+public:
+    // Arquivo de clips de uma imagem: mesmo caminho com a extensão .anim
+    static std::string sidecarPath(const std::string &imagePath);
+
+    // Retorna false (com a linha do erro no terminal) se o arquivo é inválido
+    bool load(const std::string &filePath);
+
+    int rows() const { return sheetRows; }
+    int columns() const { return sheetColumns; }
+
+    int clipCount() const { return (int)clips.size(); }
+    const AnimationClip &clip(int id) const { return clips[id]; }
+    // Id do clip com esse nome, ou -1
+    int find(const std::string &name) const;
+
+    const AnimationEvent &event(int index) const { return events[index]; }
+
+    // Registra os clips, na mesma ordem, na tabela de animações do renderer e
+    // retorna o id da primeira (id no renderer = retorno + id do clip), ou -1
+    int upload(AnimatedSpriteRenderer &renderer) const;
+
+private:
+    int sheetRows = 1, sheetColumns = 1;
+    std::vector<AnimationClip> clips;
+    std::vector<AnimationEvent> events; // agrupados por clip
+};
+
+// Evento disparado no último update: qual animador e qual evento da biblioteca
+struct AnimationHit
+{
+    int animator;
+    int event;
+};
+
+// Estado de todos os animadores de uma biblioteca, em arrays contíguos (um por
+// campo), avançado por um único update() por frame em vez de um temporizador por
+// sprite. O resultado de cada animador é o frame atual na spritesheet (layer())
+class Animators
+{
+public:
+    explicit Animators(const AnimationLibrary &library) : library(&library) {}
+
+    // Novo animador tocando o clip desde o início; retorna o id dele
+    int create(int clip);
+    // Troca o clip. Pedir o clip que já está tocando não reinicia, a não ser com restart
+    void play(int animator, int clip, bool restart = false);
+    void setSpeed(int animator, float speed) { speeds[animator] = speed; }
+
+    // Avança todos os animadores em dt segundos. Se events não for nulo, recebe os
+    // eventos dos frames alcançados neste passo
+    void update(float dt, std::vector<AnimationHit> *events = nullptr);
+
+    int size() const { return (int)clips.size(); }
+    int clip(int animator) const { return clips[animator]; }
+    // Frame atual dentro do clip e na spritesheet
+    int frame(int animator) const { return frames[animator]; }
+    int layer(int animator) const { return library->clip(clips[animator]).firstFrame + frames[animator]; }
+    // Clip sem loop que já chegou ao último frame
+    bool finished(int animator) const;
+
+private:
+    const AnimationLibrary *library;
+    std::vector<uint16_t> clips;
+    std::vector<uint16_t> frames;
+    std::vector<float> times; // segundos desde o início do clip
+    std::vector<float> speeds;
+    std::vector<uint8_t> states; // iniciado e terminado
+};
@@ -0,0 +1,206 @@
+#include "async_texture_loader.h"
+#include "gl_state.h"
+#include "texture_alpha.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// A implementação da stb_image está em texture.cpp
+#include <stb_image.h>
+
+AsyncTextureLoader::AsyncTextureLoader(int nThreads)
+{
+    if (nThreads <= 0)
+    {
+        nThreads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+    for (int i = 0; i < nThreads; i++)
+    {
+        workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+    }
+}
+
+AsyncTextureLoader::~AsyncTextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        stopping = true;
+        jobs.clear();
+    }
+    jobsReady.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    // Imagens decodificadas que nunca chegaram a ser enviadas
+    Decoded *node = completed.exchange(nullptr, std::memory_order_acquire);
+    while (node)
+    {
+        ready.push_back(node);
+        node = node->next;
+    }
+    for (Decoded *image : ready)
+    {
+        stbi_image_free(image->data);
+        delete image;
+    }
+}
+
+GLuint AsyncTextureLoader::load(const std::string &filePath, GLint filter)
+{
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glstate::bindTexture(GL_TEXTURE_2D, texID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+    // Conteúdo provisório: um pixel transparente, até a imagem ser enviada
+    const unsigned char placeholder[4] = {0, 0, 0, 0};
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+    setTextureAlpha(texID, AlphaMode::Translucent);
+
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+
+    pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        jobs.push_back(Job{filePath, texID, filter});
+    }
+    jobsReady.notify_one();
+
+    return texID;
+}
+
+void AsyncTextureLoader::workerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobsMutex);
+            jobsReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+        }
+
+        Decoded *image = new Decoded;
+        image->job = job;
+        image->data = stbi_load(job.path.c_str(), &image->width, &image->height, &image->channels, 0);
+
+        // Empilha sem trava para a thread da OpenGL
+        image->next = completed.load(std::memory_order_relaxed);
+        while (!completed.compare_exchange_weak(image->next, image, std::memory_order_release,
+                                                std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+int AsyncTextureLoader::update(int maxUploads)
+{
+    // Retira tudo o que foi decodificado; a pilha vem invertida, então cada
+    // nó é inserido na frente do trecho já retirado para manter a ordem de chegada
+    Decoded *node = completed.exchange(nullptr, std::memory_order_acquire);
+    size_t insertAt = ready.size();
+    while (node)
+    {
+        Decoded *next = node->next;
+        ready.insert(ready.begin() + insertAt, node);
+        node = next;
+    }
+
+    int uploaded = 0;
+    while (!ready.empty() && (maxUploads <= 0 || uploaded < maxUploads))
+    {
+        Decoded *image = ready.front();
+        ready.pop_front();
+
+        upload(*image);
+        stbi_image_free(image->data);
+        delete image;
+
+        pending.fetch_sub(1, std::memory_order_release);
+        uploaded++;
+    }
+    return uploaded;
+}
+
+void AsyncTextureLoader::upload(const Decoded &image)
+{
+    if (!image.data)
+    {
+        std::cout << "Failed to load texture " << image.job.path << std::endl;
+        return;
+    }
+
+    if (image.channels != 3 && image.channels != 4)
+    {
+        std::cout << "Unsupported channel count in " << image.job.path << std::endl;
+        return;
+    }
+    GLenum format = image.channels == 3 ? GL_RGB : GL_RGBA; // jpg, bmp ou png
+    GLsizeiptr size = (GLsizeiptr)image.width * image.height * image.channels;
+
+    if (!PBO)
+    {
+        glGenBuffers(1, &PBO);
+    }
+
+    // Copia os pixels para um PBO recém-orfanado: o glTexImage2D lê do buffer e
+    // retorna sem esperar a cópia para a textura terminar
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+    void *dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    bool mapped = dst != nullptr;
+    if (mapped)
+    {
+        memcpy(dst, image.data, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    else
+    {
+        // Sem o mapeamento, envia direto da memória
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    glstate::bindTexture(GL_TEXTURE_2D, image.job.texID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // linhas RGB nem sempre têm múltiplo de 4 bytes
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE,
+                 mapped ? (GLvoid *)0 : image.data);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    setTextureAlpha(image.job.texID, classifyAlpha(image.data, image.width, image.height, image.channels));
+
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+}
+
+void AsyncTextureLoader::waitAll()
+{
+    while (!done())
+    {
+        if (update(0) == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void AsyncTextureLoader::release()
+{
+    if (PBO)
+    {
+        glDeleteBuffers(1, &PBO);
+        PBO = 0;
+    }
+}
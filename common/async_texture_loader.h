@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Carregamento de texturas em segundo plano: a decodificação (stbi_load) roda em
+// um conjunto de threads e só o envio para a GPU acontece na thread da OpenGL
+// load() devolve na hora um identificador de textura válido, com um pixel
+// transparente provisório; update(), chamado a cada frame, troca o conteúdo
+// provisório pela imagem decodificada (via pixel buffer object)
+// As imagens prontas passam das threads para a thread da OpenGL por uma pilha
+// sem trava (push com compare_exchange, retirada de todas com exchange)
+class AsyncTextureLoader
+{
+public:
+    // nThreads = 0 usa o número de núcleos da máquina (menos a thread principal)
+    explicit AsyncTextureLoader(int nThreads = 0);
+    ~AsyncTextureLoader();
+
+    AsyncTextureLoader(const AsyncTextureLoader &) = delete;
+    AsyncTextureLoader &operator=(const AsyncTextureLoader &) = delete;
+
+    // Precisa de um contexto OpenGL atual: cria a textura provisória
+    GLuint load(const std::string &filePath, GLint filter = GL_NEAREST);
+
+    // Envia para a GPU até maxUploads imagens já decodificadas (0 = todas)
+    // Retorna quantas foram enviadas
+    int update(int maxUploads = 4);
+
+    // Bloqueia até que todas as texturas pedidas tenham sido enviadas
+    void waitAll();
+
+    // Nenhuma textura pendente (decodificando ou esperando envio)
+    bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    // Libera o PBO; deve ser chamado antes de destruir o contexto OpenGL
+    void release();
+
+private:
+    struct Job
+    {
+        std::string path;
+        GLuint texID;
+        GLint filter;
+    };
+
+    struct Decoded
+    {
+        Job job;
+        unsigned char *data; // nullptr se a imagem não pôde ser carregada
+        int width, height, channels;
+        Decoded *next;
+    };
+
+    void workerLoop();
+    void upload(const Decoded &image);
+
+    std::vector<std::thread> workers;
+    std::mutex jobsMutex;
+    std::condition_variable jobsReady;
+    std::deque<Job> jobs;
+    bool stopping = false;
+
+    std::atomic<Decoded *> completed{nullptr};
+    std::atomic<int> pending{0};
+
+    // Só acessados pela thread da OpenGL
+    std::deque<Decoded *> ready;
+    GLuint PBO = 0;
+};
@@ -0,0 +1,252 @@
+#include "benchmark.h"
+#include "gl_state.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    // Contagem de chamadas de desenho: os ponteiros da GLAD são trocados por versões
+    // que contam e repassam para a função original, sem mexer nos exercícios
+    int drawCounter = 0;
+    PFNGLDRAWARRAYSPROC realDrawArrays = nullptr;
+    PFNGLDRAWELEMENTSPROC realDrawElements = nullptr;
+    PFNGLDRAWARRAYSINSTANCEDPROC realDrawArraysInstanced = nullptr;
+    PFNGLDRAWELEMENTSINSTANCEDPROC realDrawElementsInstanced = nullptr;
+
+    void APIENTRY countDrawArrays(GLenum mode, GLint first, GLsizei count)
+    {
+        drawCounter++;
+        realDrawArrays(mode, first, count);
+    }
+
+    void APIENTRY countDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices)
+    {
+        drawCounter++;
+        realDrawElements(mode, count, type, indices);
+    }
+
+    void APIENTRY countDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+    {
+        drawCounter++;
+        realDrawArraysInstanced(mode, first, count, instances);
+    }
+
+    void APIENTRY countDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                                             GLsizei instances)
+    {
+        drawCounter++;
+        realDrawElementsInstanced(mode, count, type, indices, instances);
+    }
+
+    void installDrawCounters()
+    {
+        if (realDrawArrays)
+        {
+            return;
+        }
+        realDrawArrays = glad_glDrawArrays;
+        realDrawElements = glad_glDrawElements;
+        realDrawArraysInstanced = glad_glDrawArraysInstanced;
+        realDrawElementsInstanced = glad_glDrawElementsInstanced;
+        glad_glDrawArrays = countDrawArrays;
+        glad_glDrawElements = countDrawElements;
+        glad_glDrawArraysInstanced = countDrawArraysInstanced;
+        glad_glDrawElementsInstanced = countDrawElementsInstanced;
+    }
+
+    // Percentil pelo método do posto mais próximo
+    double percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        size_t rank = (size_t)(p / 100.0 * values.size() + 0.5);
+        rank = std::min(std::max(rank, (size_t)1), values.size());
+        return values[rank - 1];
+    }
+
+    void writeStats(std::ostream &out, const char *key, const std::vector<double> &values)
+    {
+        double sum = 0.0;
+        for (double v : values)
+        {
+            sum += v;
+        }
+        out << "  \"" << key << "\": {\"mean\": " << (values.empty() ? 0.0 : sum / values.size())
+            << ", \"p50\": " << percentile(values, 50) << ", \"p95\": " << percentile(values, 95)
+            << ", \"p99\": " << percentile(values, 99) << "}";
+    }
+}
+
+Benchmark::Benchmark(const char *name, int argc, char **argv) : name(name)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+        {
+            isHeadless = true;
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            framesToRun = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+        {
+            warmup = std::max(0, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc)
+        {
+            outputPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--overdraw") == 0)
+        {
+            showOverdraw = true;
+        }
+    }
+}
+
+void Benchmark::setup(GLFWwindow *window, int width, int height)
+{
+    this->window = window;
+
+    if (isHeadless)
+    {
+        // A janela invisível não tem um framebuffer padrão confiável: desenha em um FBO
+        glGenRenderbuffers(1, &colorRBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+        glGenRenderbuffers(1, &depthRBO);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &FBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cerr << "FBO do modo headless incompleto" << std::endl;
+        }
+        glstate::viewport(0, 0, width, height);
+    }
+
+    if (showOverdraw)
+    {
+        // Headless: o tamanho do FBO acima; na janela, o do framebuffer dela
+        overdraw.init(window, isHeadless ? width : 0, isHeadless ? height : 0);
+    }
+
+    if (enabled())
+    {
+        installDrawCounters();
+        cpuMs.reserve(framesToRun);
+        frameMs.reserve(framesToRun);
+        drawCalls.reserve(framesToRun);
+    }
+}
+
+void Benchmark::beginFrame()
+{
+    if (FBO)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    }
+    overdraw.beginFrame();
+    if (!enabled())
+    {
+        return;
+    }
+    drawCounter = 0;
+    frameStart = std::chrono::steady_clock::now();
+}
+
+void Benchmark::endFrame()
+{
+    // Os desenhos do mapa de calor não entram na contagem da cena
+    int sceneDrawCalls = drawCounter;
+    overdraw.endFrame(FBO);
+    if (!enabled())
+    {
+        return;
+    }
+
+    auto submitted = std::chrono::steady_clock::now();
+    glFinish();
+    auto finished = std::chrono::steady_clock::now();
+
+    if (frame >= warmup)
+    {
+        cpuMs.push_back(std::chrono::duration<double, std::milli>(submitted - frameStart).count());
+        frameMs.push_back(std::chrono::duration<double, std::milli>(finished - frameStart).count());
+        drawCalls.push_back(sceneDrawCalls);
+    }
+
+    if (++frame >= framesToRun + warmup)
+    {
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+    }
+}
+
+void Benchmark::report()
+{
+    overdraw.release();
+    if (FBO)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &FBO);
+        glDeleteRenderbuffers(1, &colorRBO);
+        glDeleteRenderbuffers(1, &depthRBO);
+        FBO = colorRBO = depthRBO = 0;
+    }
+    if (!enabled())
+    {
+        return;
+    }
+
+    double drawSum = 0.0;
+    int drawMax = 0;
+    for (int calls : drawCalls)
+    {
+        drawSum += calls;
+        drawMax = std::max(drawMax, calls);
+    }
+
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"name\": \"" << name << "\",\n";
+    json << "  \"renderer\": \"" << (const char *)glGetString(GL_RENDERER) << "\",\n";
+    json << "  \"headless\": " << (isHeadless ? "true" : "false") << ",\n";
+    json << "  \"frames\": " << cpuMs.size() << ",\n";
+    writeStats(json, "cpu_ms", cpuMs);
+    json << ",\n";
+    writeStats(json, "frame_ms", frameMs);
+    json << ",\n";
+    json << "  \"draw_calls\": {\"mean\": " << (drawCalls.empty() ? 0.0 : drawSum / drawCalls.size())
+         << ", \"max\": " << drawMax << "}";
+    if (showOverdraw)
+    {
+        // Fragmentos por pixel: média dos frames e pior pixel visto
+        json << ",\n  \"overdraw\": {\"mean\": " << overdraw.averageOverdraw() << ", \"max\": " << overdraw.maxOverdraw()
+             << "}";
+    }
+    json << "\n";
+    json << "}\n";
+
+    if (outputPath.empty())
+    {
+        std::cout << json.str();
+    }
+    else
+    {
+        std::ofstream(outputPath) << json.str();
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "overdraw.h"
+
+// Modo de benchmark dos exercícios, ativado pela linha de comando:
+//   --headless          janela invisível, desenho em um FBO (sem precisar de tela)
+//   --frames N          roda N frames e fecha a janela (sem isso, nada é medido)
+//   --warmup N          descarta os N primeiros frames das estatísticas (padrão 10)
+//   --bench-out ARQ     grava o relatório JSON em ARQ (padrão: saída padrão)
+//   --overdraw          mostra o mapa de calor de fragmentos por pixel no lugar da
+//                       cena e manda a sobreposição média/máxima ao profiler
+//                       (OverdrawMeter); com --frames, ela também entra no relatório
+// O relatório traz p50/p95/p99 do tempo de CPU do frame (até o envio dos comandos),
+// do tempo total do frame (com glFinish, para incluir o trabalho da GPU) e o
+// número de chamadas de desenho por frame
+// Uso no game loop: beginFrame() no início de cada frame, endFrame() antes do
+// glfwSwapBuffers e report() depois do loop. Sem --frames tudo isso é um no-op
+class Benchmark
+{
+public:
+    Benchmark(const char *name, int argc, char **argv);
+
+    bool headless() const { return isHeadless; }
+    bool enabled() const { return framesToRun > 0; }
+
+    // Depois do createWindow: cria o FBO (headless) e passa a contar as chamadas de desenho
+    void setup(GLFWwindow *window, int width, int height);
+
+    void beginFrame();
+    void endFrame();
+
+    // Imprime/grava o JSON e libera o FBO
+    void report();
+
+private:
+    std::string name;
+    bool isHeadless = false;
+    int framesToRun = 0;
+    int warmup = 10;
+    std::string outputPath;
+
+    GLFWwindow *window = nullptr;
+    GLuint FBO = 0, colorRBO = 0, depthRBO = 0;
+
+    bool showOverdraw = false;
+    OverdrawMeter overdraw;
+
+    int frame = 0;
+    std::chrono::steady_clock::time_point frameStart;
+    std::vector<double> cpuMs, frameMs;
+    std::vector<int> drawCalls;
+};
@@ -0,0 +1,122 @@
+#include "entity_store.h"
+
+#include <utility>
+
+namespace
+{
+    // Remove o elemento do slot trazendo o último para o lugar dele
+    template <class T>
+    void swapRemove(std::vector<T> &values, size_t slot)
+    {
+        if (slot + 1 < values.size())
+        {
+            values[slot] = std::move(values.back());
+        }
+        values.pop_back();
+    }
+}
+
+// Aplica f a cada vetor de componente; manter esta lista junto com os campos do .h
+template <class F>
+void EntityStore::forEachComponent(F f)
+{
+    f(position);
+    f(dimensions);
+    f(rotation);
+    f(iAnimation);
+    f(iFrame);
+    f(nAnimations);
+    f(nFrames);
+    f(region);
+    f(layer);
+    f(flags);
+}
+
+Entity EntityStore::create()
+{
+    Entity entity;
+    if (!freeIndices.empty())
+    {
+        entity.index = freeIndices.back();
+        freeIndices.pop_back();
+    }
+    else
+    {
+        entity.index = (uint32_t)generations.size();
+        generations.push_back(0);
+        slots.push_back(0);
+    }
+    entity.generation = generations[entity.index];
+    slots[entity.index] = (uint32_t)entities.size();
+    entities.push_back(entity);
+
+    position.push_back(glm::vec3(0.0f));
+    dimensions.push_back(glm::vec3(1.0f));
+    rotation.push_back(0.0f);
+    iAnimation.push_back(0);
+    iFrame.push_back(0);
+    nAnimations.push_back(1);
+    nFrames.push_back(1);
+    region.push_back(TextureRegion());
+    layer.push_back(0);
+    flags.push_back(ENTITY_ALIVE | ENTITY_VISIBLE);
+    return entity;
+}
+
+void EntityStore::destroy(Entity entity)
+{
+    if (!valid(entity))
+    {
+        return;
+    }
+
+    size_t slot = slots[entity.index];
+    Entity moved = entities.back();
+    forEachComponent([slot](auto &values) { swapRemove(values, slot); });
+    swapRemove(entities, slot);
+    if (slot < entities.size())
+    {
+        slots[moved.index] = (uint32_t)slot;
+    }
+
+    generations[entity.index]++;
+    freeIndices.push_back(entity.index);
+}
+
+bool EntityStore::valid(Entity entity) const
+{
+    return entity.index < generations.size() && generations[entity.index] == entity.generation;
+}
+
+void EntityStore::reserve(size_t count)
+{
+    forEachComponent([count](auto &values) { values.reserve(count); });
+    entities.reserve(count);
+}
+
+void drawSprites(const EntityStore &store, SpriteBatch &batch)
+{
+    size_t count = store.size();
+    for (size_t n = 0; n < count; n++)
+    {
+        uint32_t flags = store.flags[n];
+        if ((flags & (ENTITY_ALIVE | ENTITY_VISIBLE)) != (ENTITY_ALIVE | ENTITY_VISIBLE) || (flags & ENTITY_COLLECTED))
+        {
+            continue;
+        }
+
+        BatchSprite sprite;
+        sprite.position = store.position[n];
+        sprite.dimensions = store.dimensions[n];
+        sprite.rotation = store.rotation[n];
+        sprite.layer = store.layer[n];
+        sprite.ds = 1.0f / store.nFrames[n];
+        sprite.dt = 1.0f / store.nAnimations[n];
+        // Com flipV a coordenada local do frame já cai na última linha da textura (a de
+        // baixo na imagem): o deslocamento volta até a linha pedida, sem depender de
+        // GL_REPEAT (as regiões de um atlas não repetem)
+        int row = batch.flipsV() ? store.iAnimation[n] + 1 - store.nAnimations[n] : store.iAnimation[n];
+        sprite.offsetTex = glm::vec2(store.iFrame[n] * sprite.ds, row * sprite.dt);
+        batch.draw(sprite, store.region[n]);
+    }
+}
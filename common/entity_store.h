@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "sprite_batch.h"
+#include "texture_atlas.h"
+
+// Identificador de uma entidade: posição na tabela de índices e geração. Uma
+// entidade destruída deixa de ser válida mesmo que o índice seja reaproveitado
+struct Entity
+{
+    uint32_t index = 0xFFFFFFFF;
+    uint32_t generation = 0;
+};
+
+// Atributos de jogo de uma entidade (bits de EntityStore::flags)
+const uint32_t ENTITY_ALIVE = 1 << 0;     // isAlive dos exercícios
+const uint32_t ENTITY_COLLECTED = 1 << 1; // isCollect: já coletada, não é desenhada
+const uint32_t ENTITY_VISIBLE = 1 << 2;   // desenhada pelo drawSprites
+
+// Componentes das entidades guardados como estrutura de arrays: um vetor contíguo
+// por campo, todos com size() elementos e na mesma ordem. Os sistemas percorrem os
+// vetores de 0 a size() - 1 e só tocam nos campos que usam, em vez de carregar
+// structs inteiros (com VAO, textura e estado de animação) para ler uma posição
+// Destruir uma entidade move a última para o lugar dela, então os vetores nunca têm
+// buracos; por isso a posição nos vetores (slot) muda e fora de um laço de sistema
+// as entidades devem ser guardadas pelo Entity
+class EntityStore
+{
+public:
+    // Nova entidade com componentes padrão (posição 0, tamanho 1, visível e viva)
+    Entity create();
+    void destroy(Entity entity);
+    bool valid(Entity entity) const;
+
+    size_t size() const { return entities.size(); }
+    size_t slot(Entity entity) const { return slots[entity.index]; }
+    Entity entityAt(size_t slot) const { return entities[slot]; }
+
+    void reserve(size_t count);
+
+    // Transformação
+    std::vector<glm::vec3> position;   // centro do sprite
+    std::vector<glm::vec3> dimensions; // tamanho do frame na tela
+    std::vector<float> rotation;       // em radianos
+
+    // Frame atual de uma spritesheet com nAnimations linhas e nFrames colunas (linhas
+    // contadas de cima para baixo na imagem, como os frames dos clips)
+    std::vector<uint16_t> iAnimation, iFrame;
+    std::vector<uint16_t> nAnimations, nFrames;
+
+    // Desenho: região da textura e camada no SpriteBatch
+    std::vector<TextureRegion> region;
+    std::vector<int> layer;
+
+    // Atributos de jogo (ENTITY_*)
+    std::vector<uint32_t> flags;
+
+private:
+    template <class F>
+    void forEachComponent(F f);
+
+    std::vector<Entity> entities;      // entidade de cada slot
+    std::vector<uint32_t> slots;       // slot de cada índice
+    std::vector<uint32_t> generations; // geração atual de cada índice
+    std::vector<uint32_t> freeIndices;
+};
+
+// Envia ao batch as entidades visíveis, vivas e não coletadas
+void drawSprites(const EntityStore &store, SpriteBatch &batch);
@@ -0,0 +1,84 @@
+#include "game_loop.h"
+
+#include <chrono>
+#include <thread>
+
+GameLoop::GameLoop(GLFWwindow *window, const GameLoopSettings &settings) : settings(settings)
+{
+    // O intervalo de troca vale para o contexto atual (o da janela)
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(settings.swapInterval);
+
+    // Período esperado: o limite de FPS, ou a taxa de atualização do monitor com vsync
+    if (settings.maxFps > 0.0)
+    {
+        expectedPeriod = 1.0 / settings.maxFps;
+    }
+    else if (settings.swapInterval > 0)
+    {
+        const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        int refreshRate = mode && mode->refreshRate > 0 ? mode->refreshRate : 60;
+        expectedPeriod = (double)settings.swapInterval / refreshRate;
+    }
+
+    previousStart = glfwGetTime();
+}
+
+void GameLoop::beginFrame()
+{
+    frameStart = glfwGetTime();
+    double elapsed = frameStart - previousStart;
+    previousStart = frameStart;
+
+    if (expectedPeriod > 0.0 && elapsed > expectedPeriod * 1.5)
+    {
+        dropped++;
+    }
+
+    accumulator += elapsed;
+    stepsThisFrame = 0;
+}
+
+bool GameLoop::step()
+{
+    if (accumulator < settings.fixedDt)
+    {
+        return false;
+    }
+
+    if (stepsThisFrame >= settings.maxStepsPerFrame)
+    {
+        // A simulação não consegue acompanhar o tempo real: descarta o atraso
+        // em vez de tentar recuperá-lo nos próximos frames
+        long long behind = (long long)(accumulator / settings.fixedDt);
+        skippedSteps += behind;
+        accumulator -= behind * settings.fixedDt;
+        return false;
+    }
+
+    accumulator -= settings.fixedDt;
+    stepsThisFrame++;
+    steps++;
+    return true;
+}
+
+void GameLoop::endFrame()
+{
+    if (settings.maxFps <= 0.0)
+    {
+        return;
+    }
+
+    // Dorme até perto do fim do período e completa o último milissegundo cedendo a
+    // CPU, já que o sleep do sistema costuma acordar com atraso
+    double target = frameStart + 1.0 / settings.maxFps;
+    double remaining = target - glfwGetTime();
+    if (remaining > 0.002)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.001));
+    }
+    while (glfwGetTime() < target)
+    {
+        std::this_thread::yield();
+    }
+}
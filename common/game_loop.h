@@ -0,0 +1,58 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+struct GameLoopSettings
+{
+    double fixedDt = 1.0 / 60.0; // passo da simulação, em segundos
+    int swapInterval = 1;        // 1 = vsync, 0 = sem vsync
+    double maxFps = 0.0;         // limite de frames por segundo com sleep (0 = sem limite)
+    int maxStepsPerFrame = 5;    // evita a "espiral da morte" quando um frame demora demais
+};
+
+// Game loop com simulação em passo fixo desacoplada do desenho
+// A cada frame, o tempo real decorrido é somado a um acumulador e a simulação
+// avança em passos de fixedDt enquanto houver tempo acumulado; o que sobra vira
+// alpha (0..1), usado para interpolar o estado entre o passo anterior e o atual
+// Uso:
+//   GameLoop loop(window, settings);
+//   while (!glfwWindowShouldClose(window)) {
+//       loop.beginFrame();
+//       while (loop.step()) { atualizar(loop.dt()); }
+//       desenhar(loop.alpha());
+//       glfwSwapBuffers(window);
+//       loop.endFrame();
+//   }
+class GameLoop
+{
+public:
+    GameLoop(GLFWwindow *window, const GameLoopSettings &settings = GameLoopSettings());
+
+    void beginFrame();
+    // Retorna true enquanto houver um passo de simulação a executar neste frame
+    bool step();
+    // Espera o restante do frame se houver limite de FPS e conta frames perdidos
+    void endFrame();
+
+    double dt() const { return settings.fixedDt; }
+    // Fração do próximo passo já decorrida: estado = mix(anterior, atual, alpha)
+    float alpha() const { return (float)(accumulator / settings.fixedDt); }
+    // Tempo de simulação (número de passos executados * dt)
+    double simulationTime() const { return steps * settings.fixedDt; }
+
+    // Frames que levaram mais de 1,5x o período esperado
+    long long droppedFrames() const { return dropped; }
+    // Passos descartados por causa do limite maxStepsPerFrame
+    long long droppedSteps() const { return skippedSteps; }
+
+private:
+    GameLoopSettings settings;
+    double frameStart = 0.0;
+    double previousStart = 0.0;
+    double accumulator = 0.0;
+    int stepsThisFrame = 0;
+    long long steps = 0;
+    long long dropped = 0;
+    long long skippedSteps = 0;
+    double expectedPeriod = 0.0; // período esperado de um frame (limite de FPS ou taxa da tela)
+};
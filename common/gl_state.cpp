@@ -0,0 +1,281 @@
+#include "gl_state.h"
+
+#include <array>
+
+namespace
+{
+    const int MAX_TEXTURE_UNITS = 16;
+
+    // Valor em cache; inválido significa "estado desconhecido" (sempre envia)
+    template <typename T>
+    struct Cached
+    {
+        using Value = T;
+        T value{};
+        bool valid = false;
+    };
+
+    struct Capability
+    {
+        GLenum cap;
+        Cached<bool> enabled;
+    };
+
+    struct State
+    {
+        Cached<GLuint> program;
+        Cached<GLuint> vao;
+        Cached<GLenum> activeUnit;
+        Cached<GLuint> texture2D[MAX_TEXTURE_UNITS];
+        Cached<GLuint> texture2DArray[MAX_TEXTURE_UNITS];
+        Capability capabilities[5] = {{GL_BLEND, {}}, {GL_DEPTH_TEST, {}}, {GL_CULL_FACE, {}}, {GL_SCISSOR_TEST, {}},
+                                      {GL_MULTISAMPLE, {}}};
+        Cached<std::array<GLenum, 2>> blendFunc;
+        Cached<GLenum> depthFunc;
+        Cached<GLboolean> depthMask;
+        Cached<std::array<GLfloat, 4>> clearColor;
+        Cached<GLfloat> lineWidth;
+        Cached<GLfloat> pointSize;
+        Cached<std::array<GLint, 4>> viewport;
+    };
+
+    State state;
+    glstate::Stats counters;
+
+    // Atualiza o cache e retorna true se a chamada precisa ser enviada
+    template <typename T>
+    bool update(Cached<T> &cached, const typename Cached<T>::Value &value)
+    {
+        if (cached.valid && cached.value == value)
+        {
+            counters.elided++;
+            return false;
+        }
+        cached.value = value;
+        cached.valid = true;
+        counters.issued++;
+        return true;
+    }
+
+    Cached<GLuint> *textureSlot(GLenum target)
+    {
+        if (!state.activeUnit.valid)
+        {
+            return nullptr;
+        }
+        int unit = state.activeUnit.value - GL_TEXTURE0;
+        if (unit < 0 || unit >= MAX_TEXTURE_UNITS)
+        {
+            return nullptr;
+        }
+        if (target == GL_TEXTURE_2D)
+        {
+            return &state.texture2D[unit];
+        }
+        if (target == GL_TEXTURE_2D_ARRAY)
+        {
+            return &state.texture2DArray[unit];
+        }
+        return nullptr;
+    }
+
+    Capability *findCapability(GLenum cap)
+    {
+        for (Capability &c : state.capabilities)
+        {
+            if (c.cap == cap)
+            {
+                return &c;
+            }
+        }
+        return nullptr;
+    }
+
+    void forgetAllTextures()
+    {
+        for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+        {
+            state.texture2D[i].valid = false;
+            state.texture2DArray[i].valid = false;
+        }
+    }
+}
+
+namespace glstate
+{
+    void useProgram(GLuint program)
+    {
+        if (update(state.program, program))
+        {
+            glUseProgram(program);
+        }
+    }
+
+    void bindVertexArray(GLuint vao)
+    {
+        if (update(state.vao, vao))
+        {
+            glBindVertexArray(vao);
+        }
+    }
+
+    void activeTexture(GLenum unit)
+    {
+        if (update(state.activeUnit, unit))
+        {
+            glActiveTexture(unit);
+        }
+    }
+
+    void bindTexture(GLenum target, GLuint texture)
+    {
+        Cached<GLuint> *slot = textureSlot(target);
+        if (!slot)
+        {
+            // Unidade desconhecida: não dá para saber qual bind foi sobrescrito
+            if (!state.activeUnit.valid)
+            {
+                forgetAllTextures();
+            }
+            counters.issued++;
+            glBindTexture(target, texture);
+            return;
+        }
+        if (update(*slot, texture))
+        {
+            glBindTexture(target, texture);
+        }
+    }
+
+    void enable(GLenum cap)
+    {
+        Capability *c = findCapability(cap);
+        if (!c)
+        {
+            counters.issued++;
+            glEnable(cap);
+            return;
+        }
+        if (update(c->enabled, true))
+        {
+            glEnable(cap);
+        }
+    }
+
+    void disable(GLenum cap)
+    {
+        Capability *c = findCapability(cap);
+        if (!c)
+        {
+            counters.issued++;
+            glDisable(cap);
+            return;
+        }
+        if (update(c->enabled, false))
+        {
+            glDisable(cap);
+        }
+    }
+
+    void blendFunc(GLenum sfactor, GLenum dfactor)
+    {
+        if (update(state.blendFunc, {sfactor, dfactor}))
+        {
+            glBlendFunc(sfactor, dfactor);
+        }
+    }
+
+    void depthFunc(GLenum func)
+    {
+        if (update(state.depthFunc, func))
+        {
+            glDepthFunc(func);
+        }
+    }
+
+    void depthMask(GLboolean flag)
+    {
+        if (update(state.depthMask, flag))
+        {
+            glDepthMask(flag);
+        }
+    }
+
+    void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+    {
+        if (update(state.clearColor, {r, g, b, a}))
+        {
+            glClearColor(r, g, b, a);
+        }
+    }
+
+    void lineWidth(GLfloat width)
+    {
+        if (update(state.lineWidth, width))
+        {
+            glLineWidth(width);
+        }
+    }
+
+    void pointSize(GLfloat size)
+    {
+        if (update(state.pointSize, size))
+        {
+            glPointSize(size);
+        }
+    }
+
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (update(state.viewport, {x, y, width, height}))
+        {
+            glViewport(x, y, width, height);
+        }
+    }
+
+    void forgetProgram(GLuint program)
+    {
+        if (state.program.valid && state.program.value == program)
+        {
+            state.program.value = 0;
+        }
+    }
+
+    void forgetVertexArray(GLuint vao)
+    {
+        if (state.vao.valid && state.vao.value == vao)
+        {
+            state.vao.value = 0;
+        }
+    }
+
+    void forgetTexture(GLuint texture)
+    {
+        for (int i = 0; i < MAX_TEXTURE_UNITS; i++)
+        {
+            if (state.texture2D[i].valid && state.texture2D[i].value == texture)
+            {
+                state.texture2D[i].value = 0;
+            }
+            if (state.texture2DArray[i].valid && state.texture2DArray[i].value == texture)
+            {
+                state.texture2DArray[i].value = 0;
+            }
+        }
+    }
+
+    void invalidate()
+    {
+        state = State();
+    }
+
+    const Stats &stats()
+    {
+        return counters;
+    }
+
+    void resetStats()
+    {
+        counters = Stats();
+    }
+}
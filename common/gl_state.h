@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Camada fina de cache de estado sobre os ponteiros carregados pela GLAD
+// Cada função guarda o último valor enviado e só chama a OpenGL quando o valor
+// muda. Para o cache ser confiável, TODO bind de programa, VAO e textura deve
+// passar por aqui (inclusive no código de setup da engine)
+// Depois de um glDelete* de um objeto possivelmente vinculado, chame o forget*
+// correspondente; se algum código alterar o estado por fora, chame invalidate()
+namespace glstate
+{
+    // Contadores de chamadas enviadas à OpenGL e de chamadas descartadas por
+    // serem redundantes. Use resetStats() no início de cada frame para medir por frame
+    struct Stats
+    {
+        unsigned long issued = 0;
+        unsigned long elided = 0;
+    };
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+
+    // Unidade de textura ativa (GL_TEXTURE0, GL_TEXTURE1, ...)
+    void activeTexture(GLenum unit);
+    // Vincula a textura na unidade ativa. GL_TEXTURE_2D e GL_TEXTURE_2D_ARRAY
+    // são rastreados; outros alvos são sempre enviados
+    void bindTexture(GLenum target, GLuint texture);
+
+    // GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST e GL_MULTISAMPLE são
+    // rastreados; outras capacidades são sempre enviadas
+    void enable(GLenum cap);
+    void disable(GLenum cap);
+
+    void blendFunc(GLenum sfactor, GLenum dfactor);
+    void depthFunc(GLenum func);
+    void depthMask(GLboolean flag);
+    void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+    void lineWidth(GLfloat width);
+    void pointSize(GLfloat size);
+    void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // O objeto foi apagado: se estava vinculado, o cache passa a considerar o bind 0
+    void forgetProgram(GLuint program);
+    void forgetVertexArray(GLuint vao);
+    void forgetTexture(GLuint texture);
+
+    // Descarta todo o estado conhecido: as próximas chamadas serão enviadas
+    void invalidate();
+
+    const Stats &stats();
+    void resetStats();
+}
@@ -0,0 +1,24 @@
+#include "gl_utils.h"
+
+#include <iostream>
+
+void printGLInfo()
+{
+    // Obtendo as informações de versão
+    const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
+    const GLubyte *version = glGetString(GL_VERSION);   /* version as a string */
+    std::cout << "Renderer: " << renderer << std::endl;
+    std::cout << "OpenGL version supported " << version << std::endl;
+}
+
+bool checkGLError(const char *where)
+{
+    bool hasError = false;
+    GLenum error;
+    while ((error = glGetError()) != GL_NO_ERROR)
+    {
+        std::cout << "ERROR::GL::" << where << " 0x" << std::hex << error << std::dec << std::endl;
+        hasError = true;
+    }
+    return hasError;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Biblioteca "engine" compartilhada por todos os executáveis em src/
+// Este cabeçalho agrupa os módulos de estado, shader, textura (cache e atlas), malhas, janela, batch de sprites e mapas
+
+// GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#include "gl_state.h"
+#include "shader.h"
+#include "shader_source.h"
+#include "program_cache.h"
+#include "shader_watcher.h"
+#include "texture.h"
+#include "texture_alpha.h"
+#include "texture_cache.h"
+#include "texture_atlas.h"
+#include "async_texture_loader.h"
+#include "texture_pack.h"
+#include "mesh.h"
+#include "window.h"
+#include "overdraw.h"
+#include "benchmark.h"
+#include "profiler.h"
+#include "game_loop.h"
+#include "transform_kernel.h"
+#include "sprite_batch.h"
+#include "animated_sprites.h"
+#include "animation.h"
+#include "parallax.h"
+#include "entity_store.h"
+#include "tilemap.h"
+#include "map_file.h"
+#include "tile_flags.h"
+#include "pathfinding.h"
+
+// Imprime no terminal o renderer e a versão da OpenGL do contexto atual
+void printGLInfo();
+
+// Consulta glGetError e imprime todos os erros pendentes, indicando onde foram
+// detectados. Retorna true se algum erro foi encontrado
+bool checkGLError(const char *where);
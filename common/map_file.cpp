@@ -0,0 +1,461 @@
+#include "map_file.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    uint64_t align16(uint64_t offset)
+    {
+        return (offset + 15) & ~(uint64_t)15;
+    }
+
+    bool parseError(const std::string &sourceName, int lineNumber, const std::string &message)
+    {
+        std::cout << sourceName << ":" << lineNumber << ": " << message << std::endl;
+        return false;
+    }
+
+    struct ParsedLayer
+    {
+        std::string name;
+        std::vector<uint16_t> cells;
+    };
+}
+
+bool mapfile::cook(const std::string &text, std::vector<unsigned char> &binary, const std::string &sourceName)
+{
+    MapHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, 4);
+    header.version = VERSION;
+    header.tilesetColumns = 1;
+
+    std::vector<uint32_t> flags;
+    std::vector<MapSpawn> spawns;
+    std::vector<int> spawnLines; // linha do texto de cada spawn, para a mensagem de erro
+    std::vector<ParsedLayer> layers;
+    int rowsLeft = 0; // linhas que ainda faltam na camada atual
+
+    std::istringstream input(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line))
+    {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.erase(comment);
+        }
+        std::istringstream tokens(line);
+        std::string word;
+        if (!(tokens >> word))
+        {
+            continue;
+        }
+
+        // Linha de células da camada atual
+        if (rowsLeft > 0)
+        {
+            std::vector<uint16_t> &cells = layers.back().cells;
+            int columns = 0;
+            do
+            {
+                if (columns == (int)header.width)
+                {
+                    return parseError(sourceName, lineNumber, "too many cells in the row");
+                }
+                if (word == ".")
+                {
+                    cells.push_back(EMPTY_CELL);
+                }
+                else
+                {
+                    char *end;
+                    long tile = strtol(word.c_str(), &end, 10);
+                    if (*end || tile < 0 || tile >= EMPTY_CELL)
+                    {
+                        return parseError(sourceName, lineNumber, "invalid tile '" + word + "'");
+                    }
+                    cells.push_back((uint16_t)tile);
+                }
+                columns++;
+            } while (tokens >> word);
+            if (columns != (int)header.width)
+            {
+                return parseError(sourceName, lineNumber, "too few cells in the row");
+            }
+            rowsLeft--;
+            continue;
+        }
+
+        if (word == "size")
+        {
+            int width = 0, height = 0;
+            if (!(tokens >> width >> height) || width <= 0 || height <= 0 || !layers.empty())
+            {
+                return parseError(sourceName, lineNumber, "expected 'size <width> <height>' before the layers");
+            }
+            header.width = width;
+            header.height = height;
+        }
+        else if (word == "tileset")
+        {
+            std::string path;
+            int columns = 0;
+            if (!(tokens >> path >> columns >> header.tileWidth >> header.tileHeight) || columns <= 0 ||
+                path.size() >= PATH_SIZE)
+            {
+                return parseError(sourceName, lineNumber, "expected 'tileset <path> <columns> <width> <height>'");
+            }
+            strncpy(header.tileset, path.c_str(), PATH_SIZE - 1);
+            header.tilesetColumns = columns;
+        }
+        else if (word == "flags")
+        {
+            int tile = -1;
+            if (!(tokens >> tile) || tile < 0 || tile >= (int)MAX_TILE_TYPES)
+            {
+                return parseError(sourceName, lineNumber, "expected 'flags <tile> <flag>...'");
+            }
+            if ((int)flags.size() <= tile)
+            {
+                flags.resize(tile + 1, 0);
+            }
+            std::string flag;
+            while (tokens >> flag)
+            {
+                if (flag == "solid")
+                {
+                    flags[tile] |= TILE_SOLID;
+                }
+                else if (flag == "danger")
+                {
+                    flags[tile] |= TILE_DANGER;
+                }
+                else if (flag == "goal")
+                {
+                    flags[tile] |= TILE_GOAL;
+                }
+                else if (flag == "collectible")
+                {
+                    flags[tile] |= TILE_COLLECTIBLE;
+                }
+                else
+                {
+                    return parseError(sourceName, lineNumber, "unknown flag '" + flag + "'");
+                }
+            }
+        }
+        else if (word == "spawn")
+        {
+            std::string name;
+            MapSpawn spawn;
+            memset(&spawn, 0, sizeof(spawn));
+            if (!(tokens >> name >> spawn.line >> spawn.column) || name.size() >= NAME_SIZE)
+            {
+                return parseError(sourceName, lineNumber, "expected 'spawn <name> <line> <column>'");
+            }
+            strncpy(spawn.name, name.c_str(), NAME_SIZE - 1);
+            spawns.push_back(spawn);
+            spawnLines.push_back(lineNumber);
+        }
+        else if (word == "layer")
+        {
+            ParsedLayer layer;
+            if (!(tokens >> layer.name) || layer.name.size() >= NAME_SIZE || header.width == 0)
+            {
+                return parseError(sourceName, lineNumber, "expected 'layer <name>' after 'size'");
+            }
+            layer.cells.reserve((size_t)header.width * header.height);
+            layers.push_back(std::move(layer));
+            rowsLeft = header.height;
+        }
+        else
+        {
+            return parseError(sourceName, lineNumber, "unknown directive '" + word + "'");
+        }
+    }
+
+    if (rowsLeft > 0)
+    {
+        return parseError(sourceName, lineNumber, "layer '" + layers.back().name + "' ends too early");
+    }
+    if (layers.empty())
+    {
+        return parseError(sourceName, lineNumber, "the map has no layers");
+    }
+    // O spawn pode vir antes do size: só aqui o tamanho do mapa é conhecido
+    for (size_t i = 0; i < spawns.size(); i++)
+    {
+        if (spawns[i].line < 0 || spawns[i].line >= (int32_t)header.height || spawns[i].column < 0 ||
+            spawns[i].column >= (int32_t)header.width)
+        {
+            return parseError(sourceName, spawnLines[i], "spawn '" + std::string(spawns[i].name) + "' is outside the map");
+        }
+    }
+
+    header.layerCount = (uint32_t)layers.size();
+    header.tileTypeCount = (uint32_t)flags.size();
+    header.spawnCount = (uint32_t)spawns.size();
+
+    std::vector<MapLayer> layerTable(layers.size());
+    uint64_t offset = sizeof(header) + layers.size() * sizeof(MapLayer) + spawns.size() * sizeof(MapSpawn) +
+                      flags.size() * sizeof(uint32_t);
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        memset(&layerTable[i], 0, sizeof(MapLayer));
+        strncpy(layerTable[i].name, layers[i].name.c_str(), NAME_SIZE - 1);
+        offset = align16(offset);
+        layerTable[i].offset = offset;
+        offset += layers[i].cells.size() * sizeof(uint16_t);
+    }
+
+    binary.assign((size_t)offset, 0);
+    unsigned char *out = binary.data();
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    memcpy(out, layerTable.data(), layerTable.size() * sizeof(MapLayer));
+    out += layerTable.size() * sizeof(MapLayer);
+    if (!spawns.empty())
+    {
+        memcpy(out, spawns.data(), spawns.size() * sizeof(MapSpawn));
+        out += spawns.size() * sizeof(MapSpawn);
+    }
+    if (!flags.empty())
+    {
+        memcpy(out, flags.data(), flags.size() * sizeof(uint32_t));
+    }
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        memcpy(binary.data() + layerTable[i].offset, layers[i].cells.data(), layers[i].cells.size() * sizeof(uint16_t));
+    }
+    return true;
+}
+
+MapFile::~MapFile()
+{
+    close();
+}
+
+bool MapFile::open(const std::string &filePath)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view)
+    {
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = (const unsigned char *)view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // o mapeamento continua válido sem o descritor
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+    data = (const unsigned char *)view;
+    size = (size_t)info.st_size;
+#endif
+    mapped = true;
+
+    // Sem o cabeçalho binário, o arquivo é tratado como o texto de autoria
+    if (size < 4 || memcmp(data, mapfile::MAGIC, 4) != 0)
+    {
+        std::string text((const char *)data, size);
+        close();
+        if (!mapfile::cook(text, cooked, filePath))
+        {
+            return false;
+        }
+        data = cooked.data();
+        size = cooked.size();
+    }
+
+    if (!validate())
+    {
+        std::cout << "Invalid map file " << filePath << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Confere o cabeçalho e os limites de todas as tabelas e camadas uma única vez, para
+// que os acessos depois do open() não precisem de verificação
+bool MapFile::validate() const
+{
+    const mapfile::MapHeader &h = header();
+    if (size < sizeof(mapfile::MapHeader) || memcmp(h.magic, mapfile::MAGIC, 4) != 0 ||
+        h.version != mapfile::VERSION || h.width == 0 || h.height == 0 || h.layerCount == 0 ||
+        h.tileTypeCount > mapfile::MAX_TILE_TYPES || h.tilesetColumns == 0 ||
+        memchr(h.tileset, 0, mapfile::PATH_SIZE) == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t tables = sizeof(mapfile::MapHeader) + (uint64_t)h.tileTypeCount * sizeof(uint32_t) +
+                      (uint64_t)h.spawnCount * sizeof(mapfile::MapSpawn) +
+                      (uint64_t)h.layerCount * sizeof(mapfile::MapLayer);
+    if (tables > size)
+    {
+        return false;
+    }
+
+    // Os valores vêm do arquivo: as contas são feitas de forma que não estourem
+    uint64_t cells = (uint64_t)h.width * h.height;
+    if (cells > size / sizeof(uint16_t))
+    {
+        return false;
+    }
+    uint64_t layerBytes = cells * sizeof(uint16_t);
+    for (uint32_t i = 0; i < h.layerCount; i++)
+    {
+        const mapfile::MapLayer &entry = layers()[i];
+        if (entry.offset % 16 != 0 || entry.offset < tables || entry.offset > size ||
+            layerBytes > size - entry.offset ||
+            memchr(entry.name, 0, mapfile::NAME_SIZE) == nullptr)
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < h.spawnCount; i++)
+    {
+        const mapfile::MapSpawn &spawn = spawns()[i];
+        if (memchr(spawn.name, 0, mapfile::NAME_SIZE) == nullptr || spawn.line < 0 ||
+            spawn.line >= (int32_t)h.height || spawn.column < 0 || spawn.column >= (int32_t)h.width)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MapFile::close()
+{
+    if (mapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle((HANDLE)mappingHandle);
+        CloseHandle((HANDLE)fileHandle);
+        mappingHandle = fileHandle = nullptr;
+#else
+        munmap((void *)data, size);
+#endif
+        mapped = false;
+    }
+    cooked.clear();
+    cooked.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+}
+
+const mapfile::MapHeader &MapFile::header() const
+{
+    static const mapfile::MapHeader empty = {};
+    return data ? *(const mapfile::MapHeader *)data : empty;
+}
+
+const mapfile::MapLayer *MapFile::layers() const
+{
+    return (const mapfile::MapLayer *)(data + sizeof(mapfile::MapHeader));
+}
+
+const mapfile::MapSpawn *MapFile::spawns() const
+{
+    return (const mapfile::MapSpawn *)(layers() + header().layerCount);
+}
+
+const uint32_t *MapFile::flagTable() const
+{
+    return (const uint32_t *)(spawns() + header().spawnCount);
+}
+
+const uint16_t *MapFile::layer(int index) const
+{
+    if (!data || index < 0 || index >= layerCount())
+    {
+        return nullptr;
+    }
+    return (const uint16_t *)(data + layers()[index].offset);
+}
+
+const uint16_t *MapFile::layer(const std::string &name) const
+{
+    for (int i = 0; i < layerCount(); i++)
+    {
+        if (name == layers()[i].name)
+        {
+            return layer(i);
+        }
+    }
+    return nullptr;
+}
+
+uint32_t MapFile::tileFlags(int tile) const
+{
+    if (!data || tile < 0 || tile >= (int)header().tileTypeCount)
+    {
+        return 0;
+    }
+    return flagTable()[tile];
+}
+
+bool MapFile::spawn(const std::string &name, int &line, int &column) const
+{
+    for (uint32_t i = 0; data && i < header().spawnCount; i++)
+    {
+        if (name == spawns()[i].name)
+        {
+            line = spawns()[i].line;
+            column = spawns()[i].column;
+            return true;
+        }
+    }
+    return false;
+}
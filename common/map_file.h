@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato binário de mapa gerado pelo map_cooker (tools/) a partir de um .txt
+// [MapHeader][MapLayer x layers][MapSpawn x spawns][flags uint32 x tileTypes][camadas]
+// Cada camada é width * height valores uint16 (índice no tileset), linha a linha e
+// alinhada em 16 bytes; EMPTY_CELL (0xFFFF, o EMPTY_TILE do tilemap) marca célula vazia
+//
+// Formato texto (uma diretiva por linha, # inicia comentário):
+//   size <largura> <altura>
+//   tileset <caminho em assets/> <colunas> <largura do tile> <altura do tile>
+//   flags <tile> <solid|danger|goal|collectible>...
+//   spawn <nome> <linha> <coluna>
+//   layer <nome>
+//   <altura linhas com largura índices cada, . para célula vazia>
+namespace mapfile
+{
+    const char MAGIC[4] = {'T', 'M', 'B', '1'};
+    const uint32_t VERSION = 1;
+    const size_t NAME_SIZE = 32;
+    const size_t PATH_SIZE = 112;
+    const uint32_t MAX_TILE_TYPES = 256;
+    const uint16_t EMPTY_CELL = 0xFFFF;
+
+    // Atributos de um tipo de tile
+    const uint32_t TILE_SOLID = 1 << 0;       // não pode ser pisado
+    const uint32_t TILE_DANGER = 1 << 1;      // mata quem pisa
+    const uint32_t TILE_GOAL = 1 << 2;        // fim da fase
+    const uint32_t TILE_COLLECTIBLE = 1 << 3; // pode ser coletado
+
+    struct MapHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t width, height; // em tiles
+        uint32_t layerCount;
+        uint32_t tileTypeCount;
+        uint32_t spawnCount;
+        uint32_t tilesetColumns;
+        float tileWidth, tileHeight; // tamanho do losango 2:1
+        char tileset[PATH_SIZE];     // caminho relativo à pasta assets/
+    };
+
+    struct MapSpawn
+    {
+        char name[NAME_SIZE];
+        int32_t line, column;
+    };
+
+    struct MapLayer
+    {
+        char name[NAME_SIZE];
+        uint64_t offset; // a partir do início do arquivo
+    };
+
+    // Converte o texto em memória na imagem binária do arquivo. Retorna false (e
+    // imprime a linha com erro) se o texto não é um mapa válido
+    bool cook(const std::string &text, std::vector<unsigned char> &binary, const std::string &sourceName = "map");
+}
+
+// Mapa aberto com mapeamento em memória: as camadas são lidas direto do arquivo,
+// sem nenhuma conversão, então mesmo mapas grandes abrem em milissegundos
+// open() também aceita o .txt de autoria, que é convertido em memória (mais lento,
+// útil durante a edição da fase)
+class MapFile
+{
+public:
+    MapFile() = default;
+    ~MapFile();
+
+    MapFile(const MapFile &) = delete;
+    MapFile &operator=(const MapFile &) = delete;
+
+    // Retorna false se o arquivo não existe ou não é um mapa válido
+    bool open(const std::string &filePath);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    int width() const { return (int)header().width; }
+    int height() const { return (int)header().height; }
+    int layerCount() const { return (int)header().layerCount; }
+
+    // Células da camada (width * height, linha a linha); nullptr se não existe
+    const uint16_t *layer(int index) const;
+    const uint16_t *layer(const std::string &name) const;
+
+    // Atributos (TILE_*) do tipo de tile; 0 para tipos sem atributos
+    uint32_t tileFlags(int tile) const;
+
+    // Posição inicial (linha e coluna, a partir de 0) da entidade com esse nome
+    bool spawn(const std::string &name, int &line, int &column) const;
+
+    std::string tileset() const { return std::string(header().tileset); }
+    int tilesetColumns() const { return (int)header().tilesetColumns; }
+    float tileWidth() const { return header().tileWidth; }
+    float tileHeight() const { return header().tileHeight; }
+
+private:
+    const mapfile::MapHeader &header() const;
+    const uint32_t *flagTable() const;
+    const mapfile::MapSpawn *spawns() const;
+    const mapfile::MapLayer *layers() const;
+    bool validate() const;
+
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<unsigned char> cooked; // imagem convertida de um .txt
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+};
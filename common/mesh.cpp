@@ -0,0 +1,96 @@
+#include "mesh.h"
+#include "gl_state.h"
+
+// Cria o VBO e o VAO de uma malha de 4 vértices, no layout descrito em mesh.h
+// Quando hasTexCoords é falso, cada vértice tem apenas x, y, z
+static GLuint createQuadVAO(const GLfloat *vertices, GLsizeiptr size, bool hasTexCoords)
+{
+    GLsizei stride = (hasTexCoords ? 5 : 3) * sizeof(GLfloat);
+
+    GLuint VBO, VAO;
+    // Geração do identificador do VBO
+    glGenBuffers(1, &VBO);
+    // Faz a conexão (vincula) do buffer como um buffer de array
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // Envia os dados do array de floats para o buffer da OpenGl
+    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+
+    // Geração do identificador do VAO (Vertex Array Object)
+    glGenVertexArrays(1, &VAO);
+    // Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
+    // e os ponteiros para os atributos
+    glstate::bindVertexArray(VAO);
+
+    // Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    if (hasTexCoords)
+    {
+        // Ponteiro pro atributo 1 - Coordenada de textura s, t
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid *)(3 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(1);
+    }
+
+    // Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
+    // atualmente vinculado - para que depois possamos desvincular com segurança
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
+    glstate::bindVertexArray(0);
+
+    return VAO;
+}
+
+GLuint setupSprite()
+{
+    float ds, dt;
+    return setupSprite(1, 1, ds, dt);
+}
+
+GLuint setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
+{
+    ds = 1.0 / (float)nFrames;
+    dt = 1.0 / (float)nAnimations;
+
+    GLfloat vertices[] = {
+        // x   y    z    s     t
+        -0.5, 0.5, 0.0, 0.0, dt,   // V0
+        -0.5, -0.5, 0.0, 0.0, 0.0, // V1
+        0.5, 0.5, 0.0, ds, dt,     // V2
+        0.5, -0.5, 0.0, ds, 0.0    // V3
+    };
+
+    return createQuadVAO(vertices, sizeof(vertices), true);
+}
+
+GLuint setupTile(int nTiles, float &ds, float &dt)
+{
+    ds = 1.0 / (float)nTiles;
+    dt = 1.0;
+
+    // Como eu prefiro escalar depois, th e tw serão 1.0
+    float th = 1.0, tw = 1.0;
+
+    GLfloat vertices[] = {
+        // x   y    z    s     t
+        0.0, th / 2.0f, 0.0, 0.0, dt / 2.0f, // A
+        tw / 2.0f, th, 0.0, ds / 2.0f, dt,   // B
+        tw / 2.0f, 0.0, 0.0, ds / 2.0f, 0.0, // D
+        tw, th / 2.0f, 0.0, ds, dt / 2.0f    // C
+    };
+
+    return createQuadVAO(vertices, sizeof(vertices), true);
+}
+
+GLuint createSquare()
+{
+    GLfloat vertices[] = {
+        -0.5, 0.5, 0.0,  // v0
+        -0.5, -0.5, 0.0, // v1
+        0.5, 0.5, 0.0,   // v2
+        0.5, -0.5, 0.0,  // v3
+    };
+
+    return createQuadVAO(vertices, sizeof(vertices), false);
+}
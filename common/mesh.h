@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Malhas de quadrilátero usadas pelos exercícios. Todas são desenhadas com
+// glDrawArrays(GL_TRIANGLE_STRIP, 0, 4) e retornam o identificador do VAO
+// Layout dos atributos: 0 - posição x, y, z; 1 - coordenada de textura s, t
+
+// Quadrado unitário centrado na origem, com coordenadas de textura de 0 a 1
+GLuint setupSprite();
+
+// Quadrado unitário centrado na origem, cujas coordenadas de textura cobrem um
+// único frame de uma spritesheet com nAnimations linhas e nFrames colunas
+// ds e dt recebem o tamanho de um frame em coordenadas de textura
+GLuint setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
+
+// Losango 2:1 (tile isométrico) com largura e altura unitárias, cobrindo o
+// primeiro tile de um tileset com nTiles colunas
+GLuint setupTile(int nTiles, float &ds, float &dt);
+
+// Quadrado unitário centrado na origem, apenas com o atributo de posição
+GLuint createSquare();
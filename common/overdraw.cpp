@@ -0,0 +1,221 @@
+#include "overdraw.h"
+#include "gl_state.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+void OverdrawMeter::init(GLFWwindow *window, int width, int height)
+{
+    this->window = window;
+    fixedSize = width > 0 && height > 0;
+    if (!fixedSize)
+    {
+        glfwGetFramebufferSize(window, &width, &height);
+    }
+
+    shader = ShaderProgram::fromFiles("fullscreen.vert", "overdraw_heatmap.frag");
+    countLoc = shader.uniform("count");
+    shader.use();
+    shader.setInt(shader.uniform("maxCount"), MAX_HEAT);
+    copyShader = ShaderProgram::fromFiles("fullscreen.vert", "fullscreen_copy.frag");
+    copyShader.use();
+    copyShader.setInt(copyShader.uniform("image"), 0);
+
+    // O retângulo sai de gl_VertexID; o VAO vazio é exigido pelo perfil core
+    glGenVertexArrays(1, &VAO);
+
+    resize(width, height);
+}
+
+void OverdrawMeter::resize(int width, int height)
+{
+    if (FBO)
+    {
+        glDeleteFramebuffers(1, &FBO);
+        glDeleteTextures(1, &colorTex);
+        glstate::forgetTexture(colorTex);
+        glDeleteRenderbuffers(1, &stencilRBO);
+        glDeleteBuffers(2, PBO);
+    }
+    this->width = std::max(width, 1);
+    this->height = std::max(height, 1);
+    frame = 0;
+
+    // Cor da cena (depois, do mapa de calor) e depth/stencil: a contagem fica no stencil
+    // A cor é uma textura, lida pelo passe que copia o mapa de calor para a tela
+    glGenTextures(1, &colorTex);
+    glstate::bindTexture(GL_TEXTURE_2D, colorTex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, this->width, this->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+
+    glGenRenderbuffers(1, &stencilRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, stencilRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, this->width, this->height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTex, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, stencilRBO);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Overdraw framebuffer is incomplete" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Um byte de contagem por pixel em cada buffer
+    glGenBuffers(2, PBO);
+    for (GLuint buffer : PBO)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)this->width * this->height, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void OverdrawMeter::beginFrame()
+{
+    if (!FBO)
+    {
+        return;
+    }
+    if (!fixedSize)
+    {
+        int w, h;
+        glfwGetFramebufferSize(window, &w, &h);
+        if (w > 0 && h > 0 && (w != width || h != height))
+        {
+            resize(w, h);
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glClearStencil(0);
+    glClear(GL_STENCIL_BUFFER_BIT);
+
+    // Todo fragmento que passa no teste de profundidade soma 1 no pixel
+    glstate::enable(GL_STENCIL_TEST);
+    glStencilMask(0xFF);
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+}
+
+void OverdrawMeter::endFrame(GLuint target)
+{
+    if (!FBO)
+    {
+        return;
+    }
+
+    // Contagem deste frame para um dos pixel buffers (sem esperar a GPU)
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBO[frame % 2]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, (GLvoid *)0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    drawHeatmap(target);
+
+    readStats();
+    frame++;
+}
+
+// O mapa de calor é desenhado no FBO (o stencil escolhe os pixels de cada contagem)
+// e copiado para target por um retângulo que lê a textura de cor. Não é um
+// glBlitFramebuffer: a janela tem MSAA, e um blit para um framebuffer multisample é
+// GL_INVALID_OPERATION
+void OverdrawMeter::drawHeatmap(GLuint target)
+{
+    // A cena não sabe deste desenho: o estado que ele muda é devolvido no fim
+    GLint program = 0, vao = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+    bool blend = glIsEnabled(GL_BLEND) == GL_TRUE;
+    bool depthTest = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+    glstate::disable(GL_BLEND);
+    glstate::disable(GL_DEPTH_TEST);
+
+    // Um retângulo da tela inteira por contagem, cada um só nos pixels com ela; o
+    // último pega todos os pixels com MAX_HEAT ou mais
+    shader.use();
+    glstate::bindVertexArray(VAO);
+    for (int count = 0; count <= MAX_HEAT; count++)
+    {
+        glStencilFunc(count == MAX_HEAT ? GL_LEQUAL : GL_EQUAL, count, 0xFF);
+        shader.setInt(countLoc, count);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+    glstate::disable(GL_STENCIL_TEST);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    copyShader.use();
+    glstate::activeTexture(GL_TEXTURE0);
+    glstate::bindTexture(GL_TEXTURE_2D, colorTex);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+
+    glstate::useProgram((GLuint)program);
+    glstate::bindVertexArray((GLuint)vao);
+    if (blend)
+    {
+        glstate::enable(GL_BLEND);
+    }
+    if (depthTest)
+    {
+        glstate::enable(GL_DEPTH_TEST);
+    }
+}
+
+void OverdrawMeter::readStats()
+{
+    // O outro buffer tem a contagem do frame anterior
+    if (frame == 0)
+    {
+        return;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBO[(frame + 1) % 2]);
+    const unsigned char *counts = (const unsigned char *)glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)width * height, GL_MAP_READ_BIT);
+    if (counts)
+    {
+        size_t pixels = (size_t)width * height;
+        unsigned long long sum = 0;
+        int maxPixel = 0;
+        for (size_t i = 0; i < pixels; i++)
+        {
+            sum += counts[i];
+            maxPixel = std::max(maxPixel, (int)counts[i]);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+        double average = (double)sum / pixels;
+        profiler::counter("overdraw avg", average);
+        profiler::counter("overdraw max", maxPixel);
+        frames++;
+        sumAverage += average;
+        maxCount = std::max(maxCount, maxPixel);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void OverdrawMeter::release()
+{
+    if (!FBO)
+    {
+        return;
+    }
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteTextures(1, &colorTex);
+    glstate::forgetTexture(colorTex);
+    glDeleteRenderbuffers(1, &stencilRBO);
+    glDeleteBuffers(2, PBO);
+    glDeleteVertexArrays(1, &VAO);
+    glstate::forgetVertexArray(VAO);
+    FBO = colorTex = stencilRBO = VAO = 0;
+    PBO[0] = PBO[1] = 0;
+}
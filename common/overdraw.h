@@ -0,0 +1,58 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "shader.h"
+
+// Modo de análise de sobreposição (overdraw), ativado por --overdraw (Benchmark)
+// O frame é desenhado em um FBO próprio cujo stencil conta, em cada pixel, quantos
+// fragmentos passaram (glStencilOp com GL_INCR, satura em 255), sem mexer nos
+// shaders da cena. No fim do frame a contagem vira um mapa de calor (azul = 1
+// fragmento, vermelho = MAX_HEAT ou mais; preto = nenhum), desenhado na tela por
+// um retângulo que lê a cor do FBO (a tela pode ter MSAA, o FBO não)
+// A média e o máximo por pixel vão para o profiler ("overdraw avg"/"overdraw max")
+// A leitura do stencil passa por dois pixel buffers alternados: os valores
+// reportados são os do frame anterior, sem esperar a GPU terminar o atual
+class OverdrawMeter
+{
+public:
+    // Fragmentos por pixel que já aparecem em vermelho no mapa de calor
+    static const int MAX_HEAT = 16;
+
+    // Com o contexto OpenGL atual; width e height são o tamanho do framebuffer
+    void init(GLFWwindow *window, int width, int height);
+    bool enabled() const { return FBO != 0; }
+
+    // Passa a desenhar no FBO de contagem
+    void beginFrame();
+    // Desenha o mapa de calor em target (0 = tela) e manda as estatísticas ao profiler
+    void endFrame(GLuint target);
+
+    // Média de todos os frames medidos e máximo entre eles
+    double averageOverdraw() const { return frames ? sumAverage / frames : 0.0; }
+    int maxOverdraw() const { return maxCount; }
+
+    void release();
+
+private:
+    void resize(int width, int height);
+    void drawHeatmap(GLuint target);
+    void readStats();
+
+    GLFWwindow *window = nullptr;
+    int width = 0, height = 0;
+    bool fixedSize = false; // headless: o tamanho não acompanha a janela
+    GLuint FBO = 0, colorTex = 0, stencilRBO = 0;
+    GLuint VAO = 0;
+    GLuint PBO[2] = {0, 0};
+    int frame = 0;
+
+    ShaderProgram shader;
+    ShaderProgram copyShader; // shaders/fullscreen_copy.frag
+    int countLoc = -1;
+
+    int frames = 0;
+    double sumAverage = 0.0;
+    int maxCount = 0;
+};
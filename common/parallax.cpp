@@ -0,0 +1,266 @@
+#include "parallax.h"
+#include "gl_state.h"
+#include "texture_pack.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <iostream>
+
+// A implementação da stb_image está em texture.cpp
+#include <stb_image.h>
+
+namespace
+{
+    // Folga, em texels, em volta da área visível de cada camada: a filtragem e os
+    // mipmaps leem vizinhos de fora do retângulo com alpha > 0
+    const int COVERAGE_PADDING = 8;
+
+    struct LayerImage
+    {
+        const unsigned char *pixels = nullptr; // nível 0, RGBA8
+        unsigned char *decoded = nullptr;      // de stbi_load (nullptr se veio do pacote)
+        int width = 0, height = 0;
+        glm::vec4 bounds;
+    };
+
+    // Retângulo com alpha > 0 em coordenadas de textura, com a folga. Encostando na
+    // borda, o eixo inteiro fica visível (com GL_REPEAT a borda oposta é vizinha).
+    // Camada toda transparente: retângulo vazio (mínimo maior que o máximo)
+    glm::vec4 coverage(const unsigned char *pixels, int width, int height)
+    {
+        int minX = width, minY = height, maxX = -1, maxY = -1;
+        for (int y = 0; y < height; y++)
+        {
+            const unsigned char *row = pixels + (size_t)y * width * 4;
+            int first = -1, last = -1;
+            for (int x = 0; x < width; x++)
+            {
+                if (row[x * 4 + 3] != 0)
+                {
+                    first = first < 0 ? x : first;
+                    last = x;
+                }
+            }
+            if (first >= 0)
+            {
+                minX = std::min(minX, first);
+                maxX = std::max(maxX, last);
+                minY = std::min(minY, y);
+                maxY = y;
+            }
+        }
+        if (maxX < 0)
+        {
+            return glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+        }
+
+        minX -= COVERAGE_PADDING;
+        minY -= COVERAGE_PADDING;
+        maxX += COVERAGE_PADDING + 1;
+        maxY += COVERAGE_PADDING + 1;
+        if (minX <= 0 || maxX >= width)
+        {
+            minX = 0;
+            maxX = width;
+        }
+        if (minY <= 0 || maxY >= height)
+        {
+            minY = 0;
+            maxY = height;
+        }
+        return glm::vec4((float)minX / width, (float)minY / height, (float)maxX / width, (float)maxY / height);
+    }
+}
+
+bool ParallaxRenderer::init(const std::vector<ParallaxLayer> &layers, const TexturePack *pack, GLint filter)
+{
+    if (layers.empty() || (int)layers.size() > MAX_LAYERS)
+    {
+        std::cout << "Parallax needs 1 to " << MAX_LAYERS << " layers" << std::endl;
+        return false;
+    }
+
+    // As imagens de fora do pacote são decodificadas em paralelo, e o retângulo com
+    // alpha > 0 de cada camada é calculado na mesma tarefa
+    std::vector<LayerImage> images(layers.size());
+    std::vector<std::future<void>> tasks;
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        tasks.push_back(std::async(std::launch::async, [&, i]() {
+            LayerImage &image = images[i];
+            if (pack && pack->levels(layers[i].path) > 0)
+            {
+                image.pixels = pack->pixels(layers[i].path, 0, image.width, image.height);
+            }
+            else
+            {
+                int channels;
+                image.decoded = stbi_load(layers[i].path.c_str(), &image.width, &image.height, &channels, 4);
+                image.pixels = image.decoded;
+            }
+            if (image.pixels)
+            {
+                image.bounds = coverage(image.pixels, image.width, image.height);
+            }
+        }));
+    }
+    for (std::future<void> &task : tasks)
+    {
+        task.wait();
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (!images[i].pixels)
+        {
+            std::cout << "Failed to load texture " << layers[i].path << std::endl;
+            ok = false;
+        }
+        else if (images[i].width != images[0].width || images[i].height != images[0].height)
+        {
+            std::cout << "Parallax layer " << layers[i].path << " is " << images[i].width << "x" << images[i].height
+                      << ", expected " << images[0].width << "x" << images[0].height << std::endl;
+            ok = false;
+        }
+    }
+    if (!ok)
+    {
+        for (LayerImage &image : images)
+        {
+            stbi_image_free(image.decoded);
+        }
+        return false;
+    }
+
+    int width = images[0].width, height = images[0].height, depth = (int)layers.size();
+    // Com todas as camadas no pacote, os mipmaps prontos são usados; senão, gerados aqui
+    uint32_t packLevels = 0;
+    for (size_t i = 0; i < layers.size() && pack; i++)
+    {
+        uint32_t levels = images[i].decoded ? 0 : pack->levels(layers[i].path);
+        packLevels = i == 0 ? levels : std::min(packLevels, levels);
+    }
+
+    glGenTextures(1, &texID);
+    glstate::bindTexture(GL_TEXTURE_2D_ARRAY, texID);
+
+    // A imagem se repete na horizontal enquanto a câmera anda
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+
+    if (packLevels > 0)
+    {
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)packLevels - 1);
+        for (uint32_t level = 0; level < packLevels; level++)
+        {
+            int levelWidth = (int)texpack::levelSize(width, level), levelHeight = (int)texpack::levelSize(height, level);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, levelWidth, levelHeight, depth, 0, GL_RGBA,
+                         GL_UNSIGNED_BYTE, NULL);
+            for (int i = 0; i < depth; i++)
+            {
+                const unsigned char *pixels = pack->pixels(layers[i].path, level, levelWidth, levelHeight);
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, i, levelWidth, levelHeight, 1, GL_RGBA,
+                                GL_UNSIGNED_BYTE, pixels);
+            }
+        }
+    }
+    else
+    {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, depth, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        for (int i = 0; i < depth; i++)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                            images[i].pixels);
+        }
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+    glstate::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    this->layers = layers;
+    layerScroll.clear();
+    layerBounds.clear();
+    for (int i = 0; i < depth; i++)
+    {
+        layerScroll.push_back(glm::vec4(layers[i].speedFactor, layers[i].offsetX, 0.0f, 0.0f));
+        layerBounds.push_back(images[i].bounds);
+        stbi_image_free(images[i].decoded);
+    }
+    layersDirty = true;
+
+    shader = ShaderProgram::fromFiles("parallax.vert", "parallax.frag");
+    rectLoc = shader.uniform("rect");
+    scrollLoc = shader.uniform("scroll");
+    viewWidthLoc = shader.uniform("viewWidth");
+    layerCountLoc = shader.uniform("layerCount");
+    shader.use();
+    shader.setInt(shader.uniform("layers"), 0);
+    setRect(0.0f, 0.0f, (float)width, (float)height);
+
+    // O retângulo sai de gl_VertexID; o VAO vazio é exigido pelo perfil core
+    glGenVertexArrays(1, &VAO);
+
+    return true;
+}
+
+void ParallaxRenderer::setProjection(const glm::mat4 &projection)
+{
+    shader.use();
+    shader.setMat4(shader.uniform("projection"), projection);
+}
+
+void ParallaxRenderer::setRect(float x, float y, float width, float height)
+{
+    shader.use();
+    shader.setVec4(rectLoc, glm::vec4(x, y, width, height));
+    viewWidth = width;
+}
+
+void ParallaxRenderer::setOffset(int layer, float offsetX)
+{
+    layers[layer].offsetX = offsetX;
+    layerScroll[layer].y = offsetX;
+    layersDirty = true;
+}
+
+void ParallaxRenderer::draw()
+{
+    if (layers.empty())
+    {
+        return;
+    }
+
+    shader.use();
+    // As tabelas vão inteiras, direto (o cache de uniforms só guarda o primeiro
+    // elemento); um programa novo (hot reload) também precisa recebê-las
+    if (layersDirty || layersProgram != shader.id())
+    {
+        glUniform4fv(glGetUniformLocation(shader.id(), "layerScroll"), (GLsizei)layerScroll.size(),
+                     &layerScroll[0][0]);
+        glUniform4fv(glGetUniformLocation(shader.id(), "layerBounds"), (GLsizei)layerBounds.size(),
+                     &layerBounds[0][0]);
+        layersDirty = false;
+        layersProgram = shader.id();
+    }
+    shader.setInt(layerCountLoc, (GLint)layers.size());
+    shader.setFloat(scrollLoc, scroll);
+    shader.setFloat(viewWidthLoc, viewWidth);
+
+    glstate::activeTexture(GL_TEXTURE0);
+    glstate::bindTexture(GL_TEXTURE_2D_ARRAY, texID);
+    glstate::bindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
+
+void ParallaxRenderer::release()
+{
+    glDeleteTextures(1, &texID);
+    glDeleteVertexArrays(1, &VAO);
+    glstate::forgetTexture(texID);
+    glstate::forgetVertexArray(VAO);
+    texID = VAO = 0;
+    layers.clear();
+}
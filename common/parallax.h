@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+class TexturePack;
+
+// Camada de um fundo com parallax: imagem e fator de velocidade em relação à câmera
+struct ParallaxLayer
+{
+    std::string path;
+    float speedFactor = 1.0f;
+    float offsetX = 0.0f; // deslocamento próprio, em pixels da tela, somado ao da câmera
+};
+
+// Fundo com parallax desenhado num único passe
+// Todas as camadas (do mesmo tamanho) vão para uma GL_TEXTURE_2D_ARRAY e o fragment
+// shader (shaders/parallax.frag) compõe todas de uma vez, da frente para trás,
+// parando quando o pixel já ficou opaco: um retângulo só, em vez de um desenho (e
+// uma escrita no framebuffer) por camada
+// Para cada camada é pré-calculado o retângulo com alpha > 0; linhas e colunas
+// totalmente transparentes (céu acima das pedras, chão abaixo das nuvens) não
+// chegam a ser amostradas
+// Uso: init() com contexto OpenGL, setProjection() e setRect() e, a cada frame,
+// setScroll() e draw()
+class ParallaxRenderer
+{
+public:
+    // Mesmo tamanho dos arrays do shader
+    static const int MAX_LAYERS = 16;
+
+    // Camadas de trás para frente. Com um pacote aberto, as imagens que estão nele
+    // são enviadas direto do arquivo mapeado (com os mipmaps); as outras são
+    // decodificadas em paralelo. Retorna false se alguma não carrega ou os tamanhos
+    // são diferentes
+    bool init(const std::vector<ParallaxLayer> &layers, const TexturePack *pack = nullptr,
+              GLint filter = GL_NEAREST);
+    void setProjection(const glm::mat4 &projection);
+    // Retângulo da tela coberto pelo fundo; a imagem inteira ocupa a largura dele
+    void setRect(float x, float y, float width, float height);
+
+    // Posição da câmera em pixels da tela: cada camada anda scroll * speedFactor
+    void setScroll(float scroll) { this->scroll = scroll; }
+    void setOffset(int layer, float offsetX);
+
+    int count() const { return (int)layers.size(); }
+    // Retângulo com alpha > 0 da camada, em coordenadas de textura (uMin, vMin, uMax, vMax)
+    const glm::vec4 &bounds(int layer) const { return layerBounds[layer]; }
+
+    void draw();
+
+    // Libera a textura e o VAO (precisa do contexto OpenGL)
+    void release();
+
+    ShaderProgram &program() { return shader; }
+
+private:
+    ShaderProgram shader;
+    int rectLoc = -1;
+    int scrollLoc = -1;
+    int viewWidthLoc = -1;
+    int layerCountLoc = -1;
+    GLuint texID = 0;
+    GLuint VAO = 0;
+
+    std::vector<ParallaxLayer> layers;
+    std::vector<glm::vec4> layerScroll; // fator de velocidade, deslocamento próprio
+    std::vector<glm::vec4> layerBounds;
+    bool layersDirty = false;
+    GLuint layersProgram = 0; // programa que recebeu as tabelas por último
+    float scroll = 0.0f;
+    float viewWidth = 1.0f;
+};
@@ -0,0 +1,835 @@
+#include "pathfinding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const float SQRT2 = 1.41421356f;
+    const float INF = std::numeric_limits<float>::infinity();
+
+    const int DIRECTIONS[8][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+    // Distância octil: o custo exato em um grid de 8 direções sem obstáculos
+    float octile(int i0, int j0, int i1, int j1)
+    {
+        int di = std::abs(i1 - i0), dj = std::abs(j1 - j0);
+        return (float)std::max(di, dj) + (SQRT2 - 1.0f) * (float)std::min(di, dj);
+    }
+
+    float octile(const GridCell &a, const GridCell &b)
+    {
+        return octile(a.i, a.j, b.i, b.j);
+    }
+
+    int sign(int v)
+    {
+        return (v > 0) - (v < 0);
+    }
+}
+
+void Pathfinder::init(const TileFlagsGrid *grid, uint32_t blockMask)
+{
+    this->grid = grid;
+    this->blockMask = blockMask | mapfile::TILE_SOLID;
+    componentsDirty = true;
+    abstractionDirty = true;
+}
+
+// Os componentes são refeitos inteiros; da abstração, só o cluster da célula perde
+// os custos, e as bordas em que ela encosta têm as entradas refeitas (o que também
+// invalida os custos do cluster do outro lado)
+void Pathfinder::invalidate(int i, int j)
+{
+    componentsDirty = true;
+    if (abstractionDirty || !grid || i < 0 || i >= grid->height() || j < 0 || j >= grid->width())
+    {
+        return;
+    }
+    int cluster = clusterOf(i, j);
+    int ci = i / CLUSTER_SIZE, cj = j / CLUSTER_SIZE;
+    clusters[cluster].built = false;
+    if (j % CLUSTER_SIZE == CLUSTER_SIZE - 1 && cj + 1 < clustersWide)
+    {
+        refreshBorder(cluster, true);
+    }
+    if (j % CLUSTER_SIZE == 0 && cj > 0)
+    {
+        refreshBorder(cluster - 1, true);
+    }
+    if (i % CLUSTER_SIZE == CLUSTER_SIZE - 1 && ci + 1 < clustersHigh)
+    {
+        refreshBorder(cluster, false);
+    }
+    if (i % CLUSTER_SIZE == 0 && ci > 0)
+    {
+        refreshBorder(cluster - clustersWide, false);
+    }
+}
+
+void Pathfinder::prepare()
+{
+    if (!grid)
+    {
+        return;
+    }
+    if (componentsDirty)
+    {
+        buildComponents();
+    }
+    if (abstractionDirty)
+    {
+        buildAbstraction();
+    }
+    for (int cluster = 0; cluster < (int)clusters.size(); cluster++)
+    {
+        if (!clusters[cluster].built)
+        {
+            buildCluster(cluster);
+        }
+    }
+}
+
+// Prepara o arena para uma busca dentro de rect: em vez de limpar os nós, a geração
+// avança e todo nó de geração anterior conta como não visitado
+void Pathfinder::begin(const Rect &rect)
+{
+    bounds = rect;
+    size_t size = (size_t)(rect.i1 - rect.i0) * (rect.j1 - rect.j0);
+    if (nodes.size() < size)
+    {
+        nodes.resize(size, Node{0.0f, -1, 0});
+    }
+    if (++generation >= 0x7FFFFFFF)
+    {
+        for (Node &node : nodes)
+        {
+            node.stamp = 0;
+        }
+        generation = 1;
+    }
+    openList.clear();
+}
+
+GridCell Pathfinder::cellOf(int node) const
+{
+    int w = bounds.j1 - bounds.j0;
+    return GridCell{bounds.i0 + node / w, bounds.j0 + node % w};
+}
+
+void Pathfinder::open(int node, float g, int32_t parent, float f)
+{
+    nodes[node] = Node{g, parent, generation << 1};
+    openList.push_back(OpenNode{f, node});
+    std::push_heap(openList.begin(), openList.end());
+}
+
+void Pathfinder::reconstruct(int node, std::vector<GridCell> &path) const
+{
+    size_t first = path.size();
+    for (int n = node; n >= 0; n = nodes[n].parent)
+    {
+        path.push_back(cellOf(n));
+    }
+    std::reverse(path.begin() + first, path.end());
+}
+
+bool Pathfinder::search(const GridCell &from, const GridCell *goal, const Rect &rect)
+{
+    begin(rect);
+    open(local(from.i, from.j), 0.0f, -1, goal ? octile(from, *goal) : 0.0f);
+
+    while (!openList.empty())
+    {
+        std::pop_heap(openList.begin(), openList.end());
+        int node = openList.back().node;
+        openList.pop_back();
+        if (closed(node))
+        {
+            continue; // entrada antiga, já superada por um custo menor
+        }
+        nodes[node].stamp |= 1;
+        expanded++;
+
+        GridCell cell = cellOf(node);
+        if (goal && cell == *goal)
+        {
+            return true;
+        }
+
+        for (const int *d : DIRECTIONS)
+        {
+            int i = cell.i + d[0], j = cell.j + d[1];
+            if (!rect.contains(i, j) || !passable(i, j))
+            {
+                continue;
+            }
+            int next = local(i, j);
+            float g = nodes[node].g + (d[0] && d[1] ? SQRT2 : 1.0f);
+            if (opened(next) && (closed(next) || g >= nodes[next].g))
+            {
+                continue;
+            }
+            open(next, g, node, g + (goal ? octile(i, j, goal->i, goal->j) : 0.0f));
+        }
+    }
+    return false;
+}
+
+// Vizinho forçado ao chegar em (i, j) andando na direção (di, dj): uma célula
+// bloqueada ao lado faz com que o caminho ótimo para a célula atrás dela passe por aqui
+bool Pathfinder::hasForced(int i, int j, int di, int dj) const
+{
+    if (di && dj)
+    {
+        return (!passable(i - di, j) && passable(i - di, j + dj)) || (!passable(i, j - dj) && passable(i + di, j - dj));
+    }
+    if (di)
+    {
+        return (!passable(i, j + 1) && passable(i + di, j + 1)) || (!passable(i, j - 1) && passable(i + di, j - 1));
+    }
+    return (!passable(i + 1, j) && passable(i + 1, j + dj)) || (!passable(i - 1, j) && passable(i - 1, j + dj));
+}
+
+// Anda de (i, j) na direção (di, dj) até achar o destino, um vizinho forçado ou
+// (nas diagonais) uma reta que leva a um deles; células intermediárias não entram
+// na lista aberta
+bool Pathfinder::jump(int i, int j, int di, int dj, const GridCell &goal, GridCell &found) const
+{
+    while (true)
+    {
+        i += di;
+        j += dj;
+        if (!passable(i, j))
+        {
+            return false;
+        }
+        if ((i == goal.i && j == goal.j) || hasForced(i, j, di, dj))
+        {
+            found = GridCell{i, j};
+            return true;
+        }
+        if (di && dj)
+        {
+            GridCell ignored;
+            if (jump(i, j, di, 0, goal, ignored) || jump(i, j, 0, dj, goal, ignored))
+            {
+                found = GridCell{i, j};
+                return true;
+            }
+        }
+    }
+}
+
+bool Pathfinder::jumpPointSearch(const GridCell &from, const GridCell &to, std::vector<GridCell> &path)
+{
+    begin(Rect{0, 0, grid->height(), grid->width()});
+    open(local(from.i, from.j), 0.0f, -1, octile(from, to));
+
+    while (!openList.empty())
+    {
+        std::pop_heap(openList.begin(), openList.end());
+        int node = openList.back().node;
+        openList.pop_back();
+        if (closed(node))
+        {
+            continue;
+        }
+        nodes[node].stamp |= 1;
+        expanded++;
+
+        GridCell cell = cellOf(node);
+        if (cell == to)
+        {
+            // Os pontos de salto estão sempre em uma reta ou diagonal do anterior:
+            // as células entre eles são preenchidas passo a passo
+            std::vector<GridCell> jumpPoints;
+            reconstruct(node, jumpPoints);
+            path.push_back(jumpPoints[0]);
+            for (size_t n = 1; n < jumpPoints.size(); n++)
+            {
+                GridCell step = path.back();
+                int di = sign(jumpPoints[n].i - step.i), dj = sign(jumpPoints[n].j - step.j);
+                while (step != jumpPoints[n])
+                {
+                    step.i += di;
+                    step.j += dj;
+                    path.push_back(step);
+                }
+            }
+            return true;
+        }
+
+        // Direções a seguir: todas no início, e depois só a natural e as forçadas
+        int directions[8][2], count = 0;
+        int parent = nodes[node].parent;
+        if (parent < 0)
+        {
+            for (const int *d : DIRECTIONS)
+            {
+                directions[count][0] = d[0];
+                directions[count++][1] = d[1];
+            }
+        }
+        else
+        {
+            GridCell p = cellOf(parent);
+            int di = sign(cell.i - p.i), dj = sign(cell.j - p.j);
+            auto add = [&](int a, int b) {
+                directions[count][0] = a;
+                directions[count++][1] = b;
+            };
+            if (di && dj)
+            {
+                add(di, 0);
+                add(0, dj);
+                add(di, dj);
+                if (!passable(cell.i - di, cell.j))
+                {
+                    add(-di, dj);
+                }
+                if (!passable(cell.i, cell.j - dj))
+                {
+                    add(di, -dj);
+                }
+            }
+            else if (di)
+            {
+                add(di, 0);
+                if (!passable(cell.i, cell.j + 1))
+                {
+                    add(di, 1);
+                }
+                if (!passable(cell.i, cell.j - 1))
+                {
+                    add(di, -1);
+                }
+            }
+            else
+            {
+                add(0, dj);
+                if (!passable(cell.i + 1, cell.j))
+                {
+                    add(1, dj);
+                }
+                if (!passable(cell.i - 1, cell.j))
+                {
+                    add(-1, dj);
+                }
+            }
+        }
+
+        for (int n = 0; n < count; n++)
+        {
+            GridCell jumpPoint;
+            if (!jump(cell.i, cell.j, directions[n][0], directions[n][1], to, jumpPoint))
+            {
+                continue;
+            }
+            int next = local(jumpPoint.i, jumpPoint.j);
+            float g = nodes[node].g + octile(cell, jumpPoint);
+            if (opened(next) && (closed(next) || g >= nodes[next].g))
+            {
+                continue;
+            }
+            open(next, g, node, g + octile(jumpPoint, to));
+        }
+    }
+    return false;
+}
+
+// Rótulo de componente conexo (8 direções) de cada célula livre
+void Pathfinder::buildComponents()
+{
+    int width = grid->width(), height = grid->height();
+    components.assign((size_t)width * height, -1);
+    std::vector<int> stack;
+    int label = 0;
+    for (int start = 0; start < width * height; start++)
+    {
+        if (components[start] >= 0 || !passable(start / width, start % width))
+        {
+            continue;
+        }
+        components[start] = label;
+        stack.push_back(start);
+        while (!stack.empty())
+        {
+            int cell = stack.back();
+            stack.pop_back();
+            for (const int *d : DIRECTIONS)
+            {
+                int i = cell / width + d[0], j = cell % width + d[1];
+                if (passable(i, j) && components[i * width + j] < 0)
+                {
+                    components[i * width + j] = label;
+                    stack.push_back(i * width + j);
+                }
+            }
+        }
+        label++;
+    }
+    componentsDirty = false;
+}
+
+Pathfinder::Rect Pathfinder::clusterRect(int cluster) const
+{
+    int i0 = (cluster / clustersWide) * CLUSTER_SIZE, j0 = (cluster % clustersWide) * CLUSTER_SIZE;
+    return Rect{i0, j0, std::min(i0 + CLUSTER_SIZE, grid->height()), std::min(j0 + CLUSTER_SIZE, grid->width())};
+}
+
+// Par de nós ligando dois clusters vizinhos pelas células a e b, lado a lado
+void Pathfinder::addEntrance(const GridCell &a, const GridCell &b)
+{
+    int na = (int)abstractNodes.size();
+    abstractNodes.push_back(AbstractNode{a, clusterOf(a.i, a.j), na + 1});
+    abstractNodes.push_back(AbstractNode{b, clusterOf(b.i, b.j), na});
+    clusters[abstractNodes[na].cluster].nodes.push_back(na);
+    clusters[abstractNodes[na + 1].cluster].nodes.push_back(na + 1);
+}
+
+// Tira o par de nós first, first + 1; o último par do vetor ocupa o lugar dele
+void Pathfinder::removeEntrance(int first)
+{
+    for (int n = first; n <= first + 1; n++)
+    {
+        std::vector<int> &list = clusters[abstractNodes[n].cluster].nodes;
+        list.erase(std::find(list.begin(), list.end(), n));
+    }
+    int last = (int)abstractNodes.size() - 2;
+    if (first != last)
+    {
+        for (int n = 0; n < 2; n++)
+        {
+            abstractNodes[first + n] = abstractNodes[last + n];
+            abstractNodes[first + n].crossing = first + 1 - n;
+            std::vector<int> &list = clusters[abstractNodes[first + n].cluster].nodes;
+            *std::find(list.begin(), list.end(), last + n) = first + n;
+        }
+    }
+    abstractNodes.resize(last);
+}
+
+// Uma entrada no meio de cada trecho contínuo de células livres dos dois lados da
+// borda direita (right) ou de baixo do cluster
+void Pathfinder::addBorderEntrances(int cluster, bool right)
+{
+    Rect rect = clusterRect(cluster);
+    int start = right ? rect.i0 : rect.j0, end = right ? rect.i1 : rect.j1;
+    int runStart = -1;
+    for (int k = start; k <= end; k++)
+    {
+        bool open = k < end && (right ? passable(k, rect.j1 - 1) && passable(k, rect.j1)
+                                      : passable(rect.i1 - 1, k) && passable(rect.i1, k));
+        if (open && runStart < 0)
+        {
+            runStart = k;
+        }
+        else if (!open && runStart >= 0)
+        {
+            int mid = (runStart + k - 1) / 2;
+            if (right)
+            {
+                addEntrance(GridCell{mid, rect.j1 - 1}, GridCell{mid, rect.j1});
+            }
+            else
+            {
+                addEntrance(GridCell{rect.i1 - 1, mid}, GridCell{rect.i1, mid});
+            }
+            runStart = -1;
+        }
+    }
+}
+
+// Refaz as entradas da borda direita (right) ou de baixo do cluster; os custos dos
+// dois clusters da borda passam a ser recalculados sob demanda
+void Pathfinder::refreshBorder(int cluster, bool right)
+{
+    int neighbour = right ? cluster + 1 : cluster + clustersWide;
+    const std::vector<int> &list = clusters[cluster].nodes;
+    for (size_t n = 0; n < list.size();)
+    {
+        const AbstractNode &node = abstractNodes[list[n]];
+        const AbstractNode &other = abstractNodes[node.crossing];
+        if (other.cluster == neighbour && (right ? other.cell.j != node.cell.j : other.cell.i != node.cell.i))
+        {
+            removeEntrance(std::min(list[n], node.crossing));
+        }
+        else
+        {
+            n++;
+        }
+    }
+    addBorderEntrances(cluster, right);
+    clusters[cluster].built = false;
+    clusters[neighbour].built = false;
+    resizeAbstractSearch();
+}
+
+// O último índice é o destino de cada busca
+void Pathfinder::resizeAbstractSearch()
+{
+    abstractG.assign(abstractNodes.size() + 1, 0.0f);
+    abstractParent.assign(abstractNodes.size() + 1, -1);
+    abstractStamp.assign(abstractNodes.size() + 1, 0);
+}
+
+// Entradas de todas as bordas entre clusters. Os custos internos ficam para buildCluster
+void Pathfinder::buildAbstraction()
+{
+    int width = grid->width(), height = grid->height();
+    clustersWide = (width + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    clustersHigh = (height + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    abstractNodes.clear();
+    clusters.assign((size_t)clustersWide * clustersHigh, Cluster());
+
+    for (int cluster = 0; cluster < (int)clusters.size(); cluster++)
+    {
+        if (cluster % clustersWide + 1 < clustersWide)
+        {
+            addBorderEntrances(cluster, true);
+        }
+        if (cluster / clustersWide + 1 < clustersHigh)
+        {
+            addBorderEntrances(cluster, false);
+        }
+    }
+
+    resizeAbstractSearch();
+    abstractionDirty = false;
+}
+
+// Custos entre todas as entradas do cluster: um Dijkstra restrito ao cluster por entrada
+void Pathfinder::buildCluster(int cluster)
+{
+    Cluster &c = clusters[cluster];
+    Rect rect = clusterRect(cluster);
+    size_t count = c.nodes.size();
+    c.costs.assign(count * count, INF);
+    for (size_t a = 0; a < count; a++)
+    {
+        search(abstractNodes[c.nodes[a]].cell, nullptr, rect);
+        for (size_t b = 0; b < count; b++)
+        {
+            const GridCell &cell = abstractNodes[c.nodes[b]].cell;
+            int node = local(cell.i, cell.j);
+            if (opened(node))
+            {
+                c.costs[a * count + b] = nodes[node].g;
+            }
+        }
+    }
+    c.built = true;
+}
+
+bool Pathfinder::hierarchicalSearch(const GridCell &from, const GridCell &to, std::vector<GridCell> &path)
+{
+    if (abstractionDirty)
+    {
+        buildAbstraction();
+    }
+
+    int startCluster = clusterOf(from.i, from.j), goalCluster = clusterOf(to.i, to.j);
+    const std::vector<int> &startNodes = clusters[startCluster].nodes;
+    const std::vector<int> &goalNodes = clusters[goalCluster].nodes;
+
+    // Custos da origem até as entradas do seu cluster e das entradas do cluster do
+    // destino até ele (o movimento é simétrico, então a busca sai do destino)
+    std::vector<float> startCosts(startNodes.size(), INF), goalCosts(goalNodes.size(), INF);
+    search(from, nullptr, clusterRect(startCluster));
+    for (size_t n = 0; n < startNodes.size(); n++)
+    {
+        const GridCell &cell = abstractNodes[startNodes[n]].cell;
+        if (opened(local(cell.i, cell.j)))
+        {
+            startCosts[n] = nodes[local(cell.i, cell.j)].g;
+        }
+    }
+    search(to, nullptr, clusterRect(goalCluster));
+    for (size_t n = 0; n < goalNodes.size(); n++)
+    {
+        const GridCell &cell = abstractNodes[goalNodes[n]].cell;
+        if (opened(local(cell.i, cell.j)))
+        {
+            goalCosts[n] = nodes[local(cell.i, cell.j)].g;
+        }
+    }
+
+    // A* no grafo das entradas; o último índice é o destino
+    const int goalNode = (int)abstractNodes.size();
+    if (++abstractGeneration >= 0x7FFFFFFF)
+    {
+        std::fill(abstractStamp.begin(), abstractStamp.end(), 0);
+        abstractGeneration = 1;
+    }
+    uint32_t stamp = abstractGeneration;
+    std::vector<OpenNode> &heap = abstractOpen;
+    heap.clear();
+    auto relax = [&](int node, float g, int parent) {
+        if (abstractStamp[node] >> 1 == stamp && g >= abstractG[node])
+        {
+            return;
+        }
+        abstractG[node] = g;
+        abstractParent[node] = parent;
+        abstractStamp[node] = stamp << 1;
+        float h = node == goalNode ? 0.0f : octile(abstractNodes[node].cell, to);
+        heap.push_back(OpenNode{g + h, node});
+        std::push_heap(heap.begin(), heap.end());
+    };
+
+    for (size_t n = 0; n < startNodes.size(); n++)
+    {
+        if (startCosts[n] < INF)
+        {
+            relax(startNodes[n], startCosts[n], -1);
+        }
+    }
+
+    bool found = false;
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end());
+        int node = heap.back().node;
+        heap.pop_back();
+        if (abstractStamp[node] & 1)
+        {
+            continue;
+        }
+        abstractStamp[node] |= 1;
+        expanded++;
+        if (node == goalNode)
+        {
+            found = true;
+            break;
+        }
+
+        const AbstractNode &entrance = abstractNodes[node];
+        relax(entrance.crossing, abstractG[node] + 1.0f, node);
+
+        Cluster &cluster = clusters[entrance.cluster];
+        if (!cluster.built)
+        {
+            buildCluster(entrance.cluster);
+        }
+        size_t count = cluster.nodes.size();
+        size_t a = std::find(cluster.nodes.begin(), cluster.nodes.end(), node) - cluster.nodes.begin();
+        for (size_t b = 0; b < count; b++)
+        {
+            float cost = cluster.costs[a * count + b];
+            if (b != a && cost < INF)
+            {
+                relax(cluster.nodes[b], abstractG[node] + cost, node);
+            }
+        }
+
+        if (entrance.cluster == goalCluster)
+        {
+            size_t n = std::find(goalNodes.begin(), goalNodes.end(), node) - goalNodes.begin();
+            if (goalCosts[n] < INF)
+            {
+                relax(goalNode, abstractG[node] + goalCosts[n], node);
+            }
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+
+    std::vector<GridCell> waypoints = {to};
+    for (int node = abstractParent[goalNode]; node >= 0; node = abstractParent[node])
+    {
+        waypoints.push_back(abstractNodes[node].cell);
+    }
+    waypoints.push_back(from);
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    // Refinamento: cada trecho entre entradas fica dentro de um só cluster (ou é a
+    // travessia de uma borda, um passo só)
+    size_t first = path.size();
+    path.push_back(from);
+    for (size_t n = 1; n < waypoints.size(); n++)
+    {
+        const GridCell &a = waypoints[n - 1], &b = waypoints[n];
+        if (a == b)
+        {
+            continue;
+        }
+        if (std::abs(a.i - b.i) <= 1 && std::abs(a.j - b.j) <= 1)
+        {
+            path.push_back(b);
+            continue;
+        }
+        if (!search(a, &b, clusterRect(clusterOf(a.i, a.j))))
+        {
+            path.resize(first);
+            return false;
+        }
+        std::vector<GridCell> segment;
+        reconstruct(local(b.i, b.j), segment);
+        path.insert(path.end(), segment.begin() + 1, segment.end());
+    }
+    return true;
+}
+
+bool Pathfinder::findPath(const GridCell &from, const GridCell &to, std::vector<GridCell> &path,
+                          PathAlgorithm algorithm)
+{
+    path.clear();
+    expanded = 0;
+    int width = grid ? grid->width() : 0, height = grid ? grid->height() : 0;
+    if (from.i < 0 || from.i >= height || from.j < 0 || from.j >= width || !passable(to.i, to.j))
+    {
+        return false;
+    }
+    if (from == to)
+    {
+        path.push_back(from);
+        return true;
+    }
+
+    // A origem pode estar bloqueada (quem busca já está nela): nesse caso ela não
+    // tem componente e a consulta segue sem a recusa rápida
+    if (componentsDirty)
+    {
+        buildComponents();
+    }
+    int fromComponent = components[(size_t)from.i * width + from.j];
+    if (fromComponent >= 0 && fromComponent != components[(size_t)to.i * width + to.j])
+    {
+        return false;
+    }
+
+    switch (algorithm)
+    {
+    case PathAlgorithm::AStar:
+        if (search(from, &to, Rect{0, 0, height, width}))
+        {
+            reconstruct(local(to.i, to.j), path);
+            return true;
+        }
+        return false;
+    case PathAlgorithm::Hierarchical:
+        // Perto, a abstração não ajuda: o caminho pode nem passar pelas entradas
+        if (octile(from, to) > 2 * CLUSTER_SIZE && clusterOf(from.i, from.j) != clusterOf(to.i, to.j) &&
+            hierarchicalSearch(from, to, path))
+        {
+            return true;
+        }
+        // Sem caminho na abstração (por exemplo, só uma diagonal atravessa a borda),
+        // a busca direta decide
+        return jumpPointSearch(from, to, path);
+    case PathAlgorithm::JumpPoint:
+    default:
+        return jumpPointSearch(from, to, path);
+    }
+}
+
+PathService::PathService(const TileFlagsGrid &grid, uint32_t blockMask, PathAlgorithm algorithm)
+    : grid(grid), algorithm(algorithm)
+{
+    pathfinder.init(&this->grid, blockMask);
+    worker = std::thread(&PathService::workerLoop, this);
+}
+
+PathService::~PathService()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+int PathService::request(const GridCell &from, const GridCell &to)
+{
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = nextId++;
+        queries.push_back(Query{id, from, to});
+        pending++;
+    }
+    wake.notify_one();
+    return id;
+}
+
+void PathService::setTile(int i, int j, int tile)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    changes.push_back(TileChange{i, j, tile});
+}
+
+int PathService::poll(std::vector<Result> &out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    int count = (int)results.size();
+    for (Result &result : results)
+    {
+        out.push_back(std::move(result));
+    }
+    results.clear();
+    return count;
+}
+
+void PathService::waitAll()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending == 0; });
+}
+
+void PathService::workerLoop()
+{
+    std::vector<Query> batch;
+    std::vector<TileChange> batchChanges;
+    std::vector<Result> solved;
+    pathfinder.prepare();
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queries.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            batch.swap(queries);
+            batchChanges.swap(changes);
+        }
+
+        // As alterações chegam antes das consultas feitas depois delas
+        for (const TileChange &change : batchChanges)
+        {
+            TileFlags before = grid.flags(change.i, change.j);
+            grid.setTile(change.i, change.j, change.tile);
+            if (grid.flags(change.i, change.j) != before)
+            {
+                pathfinder.invalidate(change.i, change.j);
+            }
+        }
+        batchChanges.clear();
+
+        for (const Query &query : batch)
+        {
+            Result result;
+            result.id = query.id;
+            result.found = pathfinder.findPath(query.from, query.to, result.path, algorithm);
+            solved.push_back(std::move(result));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Result &result : solved)
+            {
+                results.push_back(std::move(result));
+            }
+            pending -= (int)batch.size();
+        }
+        solved.clear();
+        batch.clear();
+        idle.notify_all();
+    }
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tile_flags.h"
+
+// Célula do grid: linha i e coluna j, como no tilemap
+struct GridCell
+{
+    int i, j;
+
+    bool operator==(const GridCell &other) const { return i == other.i && j == other.j; }
+    bool operator!=(const GridCell &other) const { return !(*this == other); }
+};
+
+enum class PathAlgorithm
+{
+    AStar,        // A* célula a célula
+    JumpPoint,    // jump point search: mesmo caminho do A*, expandindo só os pontos de salto
+    Hierarchical, // busca na abstração por clusters; consultas curtas usam JumpPoint
+};
+
+// Busca de caminhos sobre o grid de atributos, com o mesmo movimento do FinalTask:
+// 8 direções (custo 1 nas retas e raiz de 2 nas diagonais), e a diagonal só olha a
+// célula de destino. Células com algum bit de blockMask não são atravessadas
+// Os nós da busca ficam em um arena reaproveitado entre as consultas (marcados por
+// geração, sem limpar nada), e a lista aberta é um heap sobre um vetor que também
+// é reaproveitado: depois das primeiras consultas, as buscas no grid não alocam memória
+// Para mapas grandes, a busca hierárquica divide o mapa em clusters de
+// CLUSTER_SIZE x CLUSTER_SIZE com entradas nas bordas; os custos entre as entradas
+// de um cluster são calculados na primeira vez que a busca passa por ele e ficam
+// guardados. Os componentes conexos também ficam guardados, então um destino
+// inalcançável é recusado sem busca nenhuma. Alterar uma célula (invalidate) refaz as
+// entradas só das bordas em que ela encosta e descarta os custos só dos clusters
+// afetados; os componentes são refeitos inteiros na próxima consulta
+// Não é thread-safe: para consultas em segundo plano, use o PathService
+class Pathfinder
+{
+public:
+    static const int CLUSTER_SIZE = 16;
+
+    void init(const TileFlagsGrid *grid, uint32_t blockMask = mapfile::TILE_SOLID | mapfile::TILE_DANGER);
+
+    // Caminho de from até to, incluindo as duas células. Retorna false se não há caminho
+    bool findPath(const GridCell &from, const GridCell &to, std::vector<GridCell> &path,
+                  PathAlgorithm algorithm = PathAlgorithm::Hierarchical);
+
+    // Avisa que os atributos da célula mudaram
+    void invalidate(int i, int j);
+
+    // Calcula agora todas as abstrações (componentes, entradas e custos de todos os
+    // clusters), em vez de na primeira consulta que precisa de cada uma
+    void prepare();
+
+    bool passable(int i, int j) const { return !(grid->flags(i, j) & blockMask); }
+
+    // Nós expandidos na última consulta (para comparar os algoritmos)
+    int expandedNodes() const { return expanded; }
+
+private:
+    struct Rect
+    {
+        int i0, j0, i1, j1; // [i0, i1) x [j0, j1)
+        bool contains(int i, int j) const { return i >= i0 && i < i1 && j >= j0 && j < j1; }
+    };
+
+    struct Node
+    {
+        float g;
+        int32_t parent;
+        uint32_t stamp; // geração * 2 + 1 se fechado
+    };
+
+    struct OpenNode
+    {
+        float f;
+        int32_t node;
+        bool operator<(const OpenNode &other) const { return f > other.f; } // heap de mínimo
+    };
+
+    struct AbstractNode
+    {
+        GridCell cell;
+        int cluster;
+        int crossing; // nó do outro lado da borda
+    };
+
+    struct Cluster
+    {
+        bool built = false;
+        std::vector<int> nodes;
+        std::vector<float> costs; // nodes.size() x nodes.size(), infinito se não se alcançam
+    };
+
+    // Arena
+    void begin(const Rect &rect);
+    int local(int i, int j) const { return (i - bounds.i0) * (bounds.j1 - bounds.j0) + (j - bounds.j0); }
+    GridCell cellOf(int node) const;
+    bool opened(int node) const { return nodes[node].stamp >> 1 == generation; }
+    bool closed(int node) const { return nodes[node].stamp == (generation << 1 | 1); }
+    void open(int node, float g, int32_t parent, float f);
+    void reconstruct(int node, std::vector<GridCell> &path) const;
+
+    // Buscas em grid; com goal nulo, search é um Dijkstra que preenche o arena inteiro
+    bool search(const GridCell &from, const GridCell *goal, const Rect &rect);
+    bool jumpPointSearch(const GridCell &from, const GridCell &to, std::vector<GridCell> &path);
+    bool jump(int i, int j, int di, int dj, const GridCell &goal, GridCell &found) const;
+    bool hasForced(int i, int j, int di, int dj) const;
+    bool hierarchicalSearch(const GridCell &from, const GridCell &to, std::vector<GridCell> &path);
+
+    // Abstrações guardadas
+    void buildComponents();
+    void buildAbstraction();
+    void addEntrance(const GridCell &a, const GridCell &b);
+    void removeEntrance(int first);
+    void addBorderEntrances(int cluster, bool right);
+    void refreshBorder(int cluster, bool right);
+    void resizeAbstractSearch();
+    void buildCluster(int cluster);
+    int clusterOf(int i, int j) const { return (i / CLUSTER_SIZE) * clustersWide + j / CLUSTER_SIZE; }
+    Rect clusterRect(int cluster) const;
+
+    const TileFlagsGrid *grid = nullptr;
+    uint32_t blockMask = mapfile::TILE_SOLID;
+    int expanded = 0;
+
+    std::vector<Node> nodes;
+    std::vector<OpenNode> openList;
+    uint32_t generation = 0;
+    Rect bounds = {0, 0, 0, 0};
+
+    std::vector<int32_t> components; // -1 nas células bloqueadas
+    bool componentsDirty = true;
+
+    std::vector<AbstractNode> abstractNodes;
+    std::vector<Cluster> clusters;
+    int clustersWide = 0, clustersHigh = 0;
+    bool abstractionDirty = true;
+
+    // Estado da busca na abstração, também reaproveitado
+    std::vector<float> abstractG;
+    std::vector<int32_t> abstractParent;
+    std::vector<uint32_t> abstractStamp;
+    std::vector<OpenNode> abstractOpen;
+    uint32_t abstractGeneration = 0;
+};
+
+// Consultas de caminho em lote, resolvidas em uma thread própria: request() só
+// enfileira e devolve um identificador; a thread pega todas as consultas pendentes
+// de uma vez e as respostas são retiradas com poll(), a cada frame
+// A thread trabalha sobre uma cópia do grid de atributos; alterações no mapa são
+// repassadas com setTile() e aplicadas antes do próximo lote. Ao iniciar, a thread
+// já prepara as abstrações do mapa (Pathfinder::prepare)
+class PathService
+{
+public:
+    explicit PathService(const TileFlagsGrid &grid, uint32_t blockMask = mapfile::TILE_SOLID | mapfile::TILE_DANGER,
+                         PathAlgorithm algorithm = PathAlgorithm::Hierarchical);
+    ~PathService();
+
+    PathService(const PathService &) = delete;
+    PathService &operator=(const PathService &) = delete;
+
+    struct Result
+    {
+        int id;
+        bool found;
+        std::vector<GridCell> path;
+    };
+
+    int request(const GridCell &from, const GridCell &to);
+    void setTile(int i, int j, int tile);
+
+    // Move as respostas prontas para results (no fim) e retorna quantas foram movidas
+    int poll(std::vector<Result> &results);
+
+    // Bloqueia até que todas as consultas pedidas tenham resposta
+    void waitAll();
+
+private:
+    struct Query
+    {
+        int id;
+        GridCell from, to;
+    };
+
+    struct TileChange
+    {
+        int i, j, tile;
+    };
+
+    void workerLoop();
+
+    TileFlagsGrid grid; // só acessado pela thread
+    Pathfinder pathfinder;
+    PathAlgorithm algorithm;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake, idle;
+    std::vector<Query> queries;
+    std::vector<TileChange> changes;
+    std::vector<Result> results;
+    int nextId = 1;
+    int pending = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,367 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace
+{
+    const size_t RING_SIZE = 256; // frames guardados
+
+    struct Event
+    {
+        const char *name;
+        int depth;
+        int64_t startNs, endNs;
+        int64_t gpuNs; // -1 enquanto a query não foi lida (ou se não há query)
+    };
+
+    struct Counter
+    {
+        const char *name;
+        int64_t ns;
+        double value;
+    };
+
+    struct Frame
+    {
+        uint64_t index = 0;
+        int64_t startNs = 0, endNs = 0;
+        std::vector<Event> events;
+        std::vector<Counter> counters;
+    };
+
+    struct PendingQuery
+    {
+        uint64_t frame;
+        size_t event;
+        GLuint query;
+    };
+
+    std::vector<Frame> ring(RING_SIZE);
+    uint64_t frameIndex = 0;
+    bool inFrame = false;
+
+    std::vector<size_t> openScopes; // eventos abertos do frame atual (pilha)
+    size_t gpuScope = SIZE_MAX;     // evento com a query ativa, se houver
+    GLuint gpuQuery = 0;
+
+    std::vector<GLuint> freeQueries;
+    std::deque<PendingQuery> pendingQueries;
+
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    Frame &currentFrame()
+    {
+        return ring[frameIndex % RING_SIZE];
+    }
+
+    // Lê, em ordem, as queries que já terminaram; para na primeira que ainda não está pronta
+    void resolveQueries()
+    {
+        while (!pendingQueries.empty())
+        {
+            PendingQuery &pending = pendingQueries.front();
+            GLuint available = 0;
+            glGetQueryObjectuiv(pending.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+            {
+                return;
+            }
+
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(pending.query, GL_QUERY_RESULT, &elapsed);
+
+            // O frame pode já ter sido sobrescrito no buffer circular
+            Frame &frame = ring[pending.frame % RING_SIZE];
+            if (frame.index == pending.frame && pending.event < frame.events.size())
+            {
+                frame.events[pending.event].gpuNs = (int64_t)elapsed;
+            }
+
+            freeQueries.push_back(pending.query);
+            pendingQueries.pop_front();
+        }
+    }
+}
+
+void profiler::beginFrame()
+{
+    if (inFrame)
+    {
+        endFrame();
+    }
+
+    Frame &frame = currentFrame();
+    frame.index = frameIndex;
+    frame.startNs = nowNs();
+    frame.endNs = frame.startNs;
+    frame.events.clear();
+    frame.counters.clear();
+
+    openScopes.clear();
+    inFrame = true;
+}
+
+void profiler::endFrame()
+{
+    if (!inFrame)
+    {
+        return;
+    }
+
+    // Escopos que ficaram abertos (ex.: return no meio do loop) são fechados aqui
+    while (!openScopes.empty())
+    {
+        endScope();
+    }
+
+    currentFrame().endNs = nowNs();
+    inFrame = false;
+    frameIndex++;
+
+    resolveQueries();
+}
+
+void profiler::beginScope(const char *name, bool gpu)
+{
+    if (!inFrame)
+    {
+        return;
+    }
+
+    Frame &frame = currentFrame();
+    Event event;
+    event.name = name;
+    event.depth = (int)openScopes.size();
+    event.startNs = nowNs();
+    event.endNs = event.startNs;
+    event.gpuNs = -1;
+    frame.events.push_back(event);
+    openScopes.push_back(frame.events.size() - 1);
+
+    if (gpu && gpuScope == SIZE_MAX)
+    {
+        if (freeQueries.empty())
+        {
+            GLuint query;
+            glGenQueries(1, &query);
+            freeQueries.push_back(query);
+        }
+        gpuQuery = freeQueries.back();
+        freeQueries.pop_back();
+        gpuScope = frame.events.size() - 1;
+        glBeginQuery(GL_TIME_ELAPSED, gpuQuery);
+    }
+}
+
+void profiler::endScope()
+{
+    if (!inFrame || openScopes.empty())
+    {
+        return;
+    }
+
+    size_t index = openScopes.back();
+    openScopes.pop_back();
+    currentFrame().events[index].endNs = nowNs();
+
+    if (gpuScope == index)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        pendingQueries.push_back(PendingQuery{frameIndex, index, gpuQuery});
+        gpuScope = SIZE_MAX;
+    }
+}
+
+void profiler::counter(const char *name, double value)
+{
+    if (!inFrame)
+    {
+        return;
+    }
+    currentFrame().counters.push_back(Counter{name, nowNs(), value});
+}
+
+void profiler::printSummary(std::ostream &out)
+{
+    struct Total
+    {
+        const char *name;
+        int depth;
+        double cpuMs = 0.0, gpuMs = 0.0;
+        int gpuCount = 0;
+    };
+    // Chave: caminho do escopo ("/pai/filho"); a ordem do map deixa cada pai
+    // antes dos seus filhos
+    std::map<std::string, Total> totals;
+    struct CounterTotal
+    {
+        double sum = 0.0, max = 0.0;
+        int count = 0;
+    };
+    std::map<std::string, CounterTotal> counters;
+    int frames = 0;
+    double frameMs = 0.0;
+
+    for (const Frame &frame : ring)
+    {
+        if (frame.endNs <= frame.startNs)
+        {
+            continue;
+        }
+        frames++;
+        frameMs += (frame.endNs - frame.startNs) / 1e6;
+        std::vector<std::string> path;
+        for (const Event &event : frame.events)
+        {
+            path.resize(event.depth);
+            path.push_back(event.name);
+            std::string key;
+            for (const std::string &part : path)
+            {
+                key += "/" + part;
+            }
+
+            Total &total = totals[key];
+            total.name = event.name;
+            total.depth = event.depth;
+            total.cpuMs += (event.endNs - event.startNs) / 1e6;
+            if (event.gpuNs >= 0)
+            {
+                total.gpuMs += event.gpuNs / 1e6;
+                total.gpuCount++;
+            }
+        }
+        for (const Counter &counter : frame.counters)
+        {
+            CounterTotal &total = counters[counter.name];
+            total.max = total.count ? std::max(total.max, counter.value) : counter.value;
+            total.sum += counter.value;
+            total.count++;
+        }
+    }
+
+    if (!frames)
+    {
+        return;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "Profiler: média de " << frames << " frames, " << frameMs / frames << " ms por frame" << std::endl;
+    for (const auto &entry : totals)
+    {
+        const Total &total = entry.second;
+        out << std::string(2 + total.depth * 2, ' ') << total.name << ": cpu "
+            << total.cpuMs / frames << " ms";
+        if (total.gpuCount)
+        {
+            out << ", gpu " << total.gpuMs / total.gpuCount << " ms";
+        }
+        out << std::endl;
+    }
+    for (const auto &entry : counters)
+    {
+        const CounterTotal &total = entry.second;
+        out << "  " << entry.first << ": média " << total.sum / total.count << ", máximo " << total.max << std::endl;
+    }
+    out << std::defaultfloat;
+}
+
+bool profiler::exportChromeTrace(const std::string &filePath)
+{
+    std::ofstream out(filePath);
+    if (!out)
+    {
+        return false;
+    }
+
+    // Eventos completos ("ph": "X") com tempos em microssegundos. Na linha da GPU
+    // o evento começa no instante em que foi enviado pela CPU, com a duração medida
+    // pela query. Contadores viram eventos "ph": "C" (gráfico no trace)
+    out << "{\"traceEvents\": [\n";
+    bool first = true;
+    auto write = [&](const char *name, const char *cat, int tid, int64_t startNs, int64_t durNs, uint64_t frame)
+    {
+        out << (first ? "" : ",\n") << "{\"name\": \"" << name << "\", \"cat\": \"" << cat
+            << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << tid << ", \"ts\": " << startNs / 1000.0
+            << ", \"dur\": " << durNs / 1000.0 << ", \"args\": {\"frame\": " << frame << "}}";
+        first = false;
+    };
+
+    for (uint64_t i = 0; i < RING_SIZE; i++)
+    {
+        // Do frame mais antigo para o mais recente
+        const Frame &frame = ring[(frameIndex + i) % RING_SIZE];
+        if (frame.endNs <= frame.startNs)
+        {
+            continue;
+        }
+        write("frame", "cpu", 1, frame.startNs, frame.endNs - frame.startNs, frame.index);
+        for (const Event &event : frame.events)
+        {
+            write(event.name, "cpu", 1, event.startNs, event.endNs - event.startNs, frame.index);
+            if (event.gpuNs >= 0)
+            {
+                write(event.name, "gpu", 2, event.startNs, event.gpuNs, frame.index);
+            }
+        }
+        for (const Counter &counter : frame.counters)
+        {
+            out << (first ? "" : ",\n") << "{\"name\": \"" << counter.name << "\", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+                << counter.ns / 1000.0 << ", \"args\": {\"value\": " << counter.value << "}}";
+            first = false;
+        }
+    }
+
+    out << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+    return out.good();
+}
+
+void profiler::shutdown()
+{
+    if (inFrame)
+    {
+        endFrame();
+    }
+
+    printSummary(std::cout);
+
+    const char *tracePath = std::getenv("PROFILER_TRACE");
+    if (tracePath && *tracePath)
+    {
+        if (exportChromeTrace(tracePath))
+        {
+            std::cout << "Trace do profiler gravado em " << tracePath << std::endl;
+        }
+        else
+        {
+            std::cout << "Falha ao gravar o trace do profiler em " << tracePath << std::endl;
+        }
+    }
+
+    for (const PendingQuery &pending : pendingQueries)
+    {
+        freeQueries.push_back(pending.query);
+    }
+    pendingQueries.clear();
+    if (!freeQueries.empty())
+    {
+        glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+        freeQueries.clear();
+    }
+}
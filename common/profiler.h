@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+// Profiler hierárquico do game loop
+// Escopos de CPU são medidos com steady_clock; um escopo marcado como gpu também
+// abre uma query GL_TIME_ELAPSED. As queries só são lidas quando o resultado já
+// está disponível (GL_QUERY_RESULT_AVAILABLE), alguns frames depois, então a
+// leitura nunca trava a CPU esperando a GPU
+// A OpenGL não permite duas queries GL_TIME_ELAPSED ativas ao mesmo tempo: um
+// escopo gpu dentro de outro escopo gpu é medido só na CPU
+// Contadores (counter) guardam um valor por frame, ao lado dos escopos
+// Os últimos frames ficam em um buffer circular e podem ser exportados no formato
+// de trace do Chrome (chrome://tracing ou https://ui.perfetto.dev)
+//
+// Uso no game loop:
+//   profiler::beginFrame();
+//   profiler::beginScope("desenharMapa", true); ... profiler::endScope();
+//   profiler::endFrame();
+// e, antes do glfwTerminate, profiler::shutdown()
+namespace profiler
+{
+    void beginFrame();
+    void endFrame();
+
+    // Escopos fora de um frame (antes do game loop) são ignorados
+    void beginScope(const char *name, bool gpu = false);
+    void endScope();
+
+    // Valor numérico do frame atual (ex.: sobreposição média de fragmentos); fora de
+    // um frame é ignorado. O resumo mostra média e máximo de cada contador
+    void counter(const char *name, double value);
+
+    // Versão RAII de beginScope/endScope
+    struct Scope
+    {
+        Scope(const char *name, bool gpu = false) { beginScope(name, gpu); }
+        ~Scope() { endScope(); }
+    };
+
+    // Tempo médio de CPU e de GPU de cada escopo nos frames guardados
+    void printSummary(std::ostream &out);
+
+    // Grava os frames guardados como trace do Chrome; retorna false se falhar
+    bool exportChromeTrace(const std::string &filePath);
+
+    // Imprime o resumo, grava o trace se a variável de ambiente PROFILER_TRACE
+    // tiver um caminho e libera as queries (precisa do contexto OpenGL)
+    void shutdown();
+}
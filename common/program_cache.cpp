@@ -0,0 +1,232 @@
+#include "program_cache.h"
+
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifndef ENGINE_SHADER_CACHE_DIR
+#define ENGINE_SHADER_CACHE_DIR "shader_cache"
+#endif
+
+// Constantes da OpenGL 4.1 que não estão na GLAD 4.0
+#define PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define PROGRAM_BINARY_LENGTH 0x8741
+#define NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+namespace
+{
+    typedef void(APIENTRY *GetProgramBinaryFn)(GLuint, GLsizei, GLsizei *, GLenum *, void *);
+    typedef void(APIENTRY *ProgramBinaryFn)(GLuint, GLenum, const void *, GLsizei);
+    typedef void(APIENTRY *ProgramParameteriFn)(GLuint, GLenum, GLint);
+
+    const uint32_t MAGIC = 0x42505047; // 'GPPB'
+
+    // Cabeçalho de cada arquivo do cache, seguido por length bytes do binário
+    struct CacheHeader
+    {
+        uint32_t magic;
+        uint32_t format; // binaryFormat devolvido pelo driver
+        uint64_t key;
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    std::string cacheDirectory = ENGINE_SHADER_CACHE_DIR;
+    programcache::Stats cacheStats;
+
+    bool loaded = false; // funções já buscadas (uma vez por execução)
+    GetProgramBinaryFn getProgramBinary = nullptr;
+    ProgramBinaryFn programBinary = nullptr;
+    ProgramParameteriFn programParameteri = nullptr;
+    std::string driver; // fabricante, renderer e versão: parte da chave
+
+    void loadFunctions()
+    {
+        if (loaded)
+        {
+            return;
+        }
+        loaded = true;
+
+        bool supported = (GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1)) ||
+                         glfwExtensionSupported("GL_ARB_get_program_binary");
+        GLint formats = 0;
+        if (supported)
+        {
+            glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        if (!supported || formats <= 0)
+        {
+            return;
+        }
+
+        getProgramBinary = (GetProgramBinaryFn)glfwGetProcAddress("glGetProgramBinary");
+        programBinary = (ProgramBinaryFn)glfwGetProcAddress("glProgramBinary");
+        programParameteri = (ProgramParameteriFn)glfwGetProcAddress("glProgramParameteri");
+        if (!getProgramBinary || !programBinary || !programParameteri)
+        {
+            getProgramBinary = nullptr;
+            return;
+        }
+
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+        {
+            const GLubyte *value = glGetString(name);
+            driver += value ? (const char *)value : "";
+            driver += '\n';
+        }
+    }
+
+    // FNV-1a de 64 bits
+    void hash(uint64_t &h, const char *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            h ^= (unsigned char)data[i];
+            h *= 0x100000001b3ull;
+        }
+    }
+
+    uint64_t cacheKey(const GLchar *vsSource, const GLchar *fsSource)
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        const char separator = '\0';
+        hash(h, vsSource, std::char_traits<char>::length(vsSource));
+        hash(h, &separator, 1);
+        hash(h, fsSource, std::char_traits<char>::length(fsSource));
+        hash(h, &separator, 1);
+        hash(h, driver.data(), driver.size());
+        return h;
+    }
+
+    std::filesystem::path cachePath(uint64_t key)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return std::filesystem::path(cacheDirectory) / name;
+    }
+}
+
+void programcache::setDirectory(const std::string &directory)
+{
+    cacheDirectory = directory;
+}
+
+const std::string &programcache::directory()
+{
+    return cacheDirectory;
+}
+
+bool programcache::enabled()
+{
+    loadFunctions();
+    return getProgramBinary && !cacheDirectory.empty();
+}
+
+GLuint programcache::load(const GLchar *vsSource, const GLchar *fsSource)
+{
+    if (!enabled())
+    {
+        return 0;
+    }
+
+    uint64_t key = cacheKey(vsSource, fsSource);
+    std::filesystem::path path = cachePath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return 0;
+    }
+
+    CacheHeader header;
+    std::vector<char> binary;
+    if (file.read((char *)&header, sizeof(header)) && header.magic == MAGIC && header.key == key)
+    {
+        binary.resize(header.length);
+        file.read(binary.data(), binary.size());
+    }
+    if (binary.empty() || !file)
+    {
+        return 0;
+    }
+
+    // O driver pode recusar um binário antigo (ex.: atualização sem mudar a string
+    // de versão): nesse caso a entrada é descartada e o programa é compilado
+    GLuint program = glCreateProgram();
+    programBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        glDeleteProgram(program);
+        file.close();
+        std::error_code error;
+        std::filesystem::remove(path, error);
+        return 0;
+    }
+
+    cacheStats.hits++;
+    return program;
+}
+
+void programcache::prepare(GLuint program)
+{
+    cacheStats.misses++;
+    if (enabled())
+    {
+        programParameteri(program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void programcache::store(GLuint program, const GLchar *vsSource, const GLchar *fsSource)
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+        return;
+    }
+
+    CacheHeader header = {};
+    header.magic = MAGIC;
+    header.key = cacheKey(vsSource, fsSource);
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    getProgramBinary(program, length, &written, &header.format, binary.data());
+    if (written <= 0)
+    {
+        return;
+    }
+    header.length = (uint32_t)written;
+
+    // Grava num arquivo temporário e renomeia: outra execução nunca lê um binário pela metade
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    std::filesystem::path path = cachePath(header.key);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write((const char *)&header, sizeof(header)) || !file.write(binary.data(), written))
+        {
+            std::cout << "WARNING::SHADER::CACHE_WRITE_FAILED " << temporary.string() << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+}
+
+const programcache::Stats &programcache::stats()
+{
+    return cacheStats;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include <glad/glad.h>
+
+// Cache em disco de programas de shader já linkados (glGetProgramBinary)
+// A chave é um hash do código dos dois shaders junto com o fabricante, o renderer e
+// a versão do driver, então trocar de driver ou editar um shader gera uma entrada
+// nova em vez de carregar um binário incompatível. Numa partida com o cache quente
+// o programa é carregado sem compilar nem linkar GLSL
+// As funções de binário são da OpenGL 4.1 (ou GL_ARB_get_program_binary) e a GLAD
+// do projeto é 4.0: elas são buscadas pela GLFW no primeiro uso e, sem suporte do
+// driver, o cache fica desligado e tudo é compilado como antes
+namespace programcache
+{
+    struct Stats
+    {
+        unsigned long hits = 0;   // programas carregados do disco
+        unsigned long misses = 0; // programas compilados (e gravados, se possível)
+    };
+
+    // Diretório dos binários; vazio desliga o cache. Padrão: shader_cache/ no
+    // diretório de build (ENGINE_SHADER_CACHE_DIR, definido pelo CMake)
+    void setDirectory(const std::string &directory);
+    const std::string &directory();
+
+    // O driver suporta binários de programa e o cache está ligado
+    bool enabled();
+
+    // Programa linkado a partir do cache, ou 0 se não há entrada válida
+    GLuint load(const GLchar *vsSource, const GLchar *fsSource);
+
+    // Pede ao driver que mantenha o binário: chamar antes do glLinkProgram
+    void prepare(GLuint program);
+
+    // Grava o binário de um programa linkado com sucesso
+    void store(GLuint program, const GLchar *vsSource, const GLchar *fsSource);
+
+    const Stats &stats();
+}
@@ -0,0 +1,300 @@
+#include "shader.h"
+#include "program_cache.h"
+#include "shader_source.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    bool compileShader(GLuint shader, const GLchar *source, const char *stage)
+    {
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+        // Checando erros de compilação (exibição via log no terminal)
+        GLint success;
+        GLchar infoLog[512];
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            glGetShaderInfoLog(shader, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::" << stage << "::COMPILATION_FAILED\n"
+                      << infoLog << std::endl;
+        }
+        return success;
+    }
+
+    // Programa do cache de binários ou, se não houver, compilado e linkado. ok diz
+    // se o programa é utilizável (erros já foram exibidos no terminal)
+    GLuint buildProgram(const GLchar *vsSource, const GLchar *fsSource, bool &ok)
+    {
+        GLuint shaderProgram = programcache::load(vsSource, fsSource);
+        if (shaderProgram)
+        {
+            ok = true;
+            return shaderProgram;
+        }
+
+        // Vertex shader
+        GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        bool compiled = compileShader(vertexShader, vsSource, "VERTEX");
+        // Fragment shader
+        GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+        compiled = compileShader(fragmentShader, fsSource, "FRAGMENT") && compiled;
+        // Linkando os shaders e criando o identificador do programa de shader
+        shaderProgram = glCreateProgram();
+        glAttachShader(shaderProgram, vertexShader);
+        glAttachShader(shaderProgram, fragmentShader);
+        programcache::prepare(shaderProgram);
+        glLinkProgram(shaderProgram);
+        // Checando por erros de linkagem
+        GLint success;
+        GLchar infoLog[512];
+        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+            std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
+                      << infoLog << std::endl;
+        }
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        ok = compiled && success;
+        if (ok)
+        {
+            programcache::store(shaderProgram, vsSource, fsSource);
+        }
+        return shaderProgram;
+    }
+}
+
+GLuint setupShader(const GLchar *vsSource, const GLchar *fsSource)
+{
+    bool ok;
+    return buildProgram(vsSource, fsSource, ok);
+}
+
+ShaderProgram::ShaderProgram(const GLchar *vsSource, const GLchar *fsSource)
+{
+    ID = setupShader(vsSource, fsSource);
+    reflectUniforms();
+}
+
+ShaderProgram ShaderProgram::fromFiles(const std::string &vsPath, const std::string &fsPath)
+{
+    ShaderProgram program;
+    program.vsPath = vsPath;
+    program.fsPath = fsPath;
+    program.reload();
+    return program;
+}
+
+bool ShaderProgram::reload()
+{
+    std::string vsSource, fsSource;
+    std::vector<std::string> vsFiles, fsFiles;
+    if (vsPath.empty() || !shadersource::load(vsPath, vsSource, vsFiles) ||
+        !shadersource::load(fsPath, fsSource, fsFiles))
+    {
+        return false;
+    }
+
+    // Os arquivos ficam registrados mesmo com erro de compilação: o watcher
+    // continua observando e a próxima correção é recarregada
+    sources = vsFiles;
+    sources.insert(sources.end(), fsFiles.begin(), fsFiles.end());
+
+    bool ok;
+    GLuint program = buildProgram(vsSource.c_str(), fsSource.c_str(), ok);
+    if (!ok)
+    {
+        // Mantém o programa anterior (se havia um) funcionando
+        glDeleteProgram(program);
+        return false;
+    }
+
+    GLuint previous = ID;
+    ID = program;
+    reflectUniforms();
+    if (previous)
+    {
+        // O novo programa começa com os valores padrão: reenvia os que estavam no cache
+        use();
+        for (Uniform &u : uniforms)
+        {
+            if (u.hasValue)
+            {
+                send(u);
+            }
+        }
+        glDeleteProgram(previous);
+        glstate::forgetProgram(previous);
+    }
+    return true;
+}
+
+void ShaderProgram::reflectUniforms()
+{
+    // Depois de um reload os handles já entregues continuam valendo: os uniforms
+    // antigos ficam nas mesmas posições (com localização -1 se sumiram do programa)
+    // e os novos vão para o fim da tabela
+    for (Uniform &u : uniforms)
+    {
+        u.location = -1;
+    }
+
+    GLint nUniforms = 0, maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &nUniforms);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<GLchar> name(maxNameLength > 0 ? maxNameLength : 1);
+    for (GLint i = 0; i < nUniforms; i++)
+    {
+        Uniform u;
+        GLsizei length = 0;
+        glGetActiveUniform(ID, i, (GLsizei)name.size(), &length, &u.size, &u.type, name.data());
+        std::string uniformName(name.data(), length);
+
+        // Uniforms dentro de blocos não têm localização
+        u.location = glGetUniformLocation(ID, uniformName.c_str());
+        if (u.location < 0)
+        {
+            continue;
+        }
+
+        auto known = handles.find(uniformName);
+        if (known != handles.end())
+        {
+            Uniform &old = uniforms[known->second];
+            // Tipo diferente: o valor guardado não serve mais
+            old.hasValue = old.hasValue && old.type == u.type;
+            old.location = u.location;
+            old.type = u.type;
+            old.size = u.size;
+            continue;
+        }
+
+        int handle = (int)uniforms.size();
+        uniforms.push_back(u);
+        handles[uniformName] = handle;
+
+        // Arrays são reportados como "nome[0]": registra também o nome sem o índice
+        size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos)
+        {
+            handles[uniformName.substr(0, bracket)] = handle;
+        }
+    }
+}
+
+int ShaderProgram::uniform(const std::string &name) const
+{
+    auto it = handles.find(name);
+    return it != handles.end() ? it->second : -1;
+}
+
+bool ShaderProgram::changed(int handle, const void *data, size_t bytes)
+{
+    if (handle < 0 || handle >= (int)uniforms.size())
+    {
+        return false;
+    }
+
+    Uniform &u = uniforms[handle];
+    if (u.hasValue && memcmp(u.value, data, bytes) == 0)
+    {
+        return false;
+    }
+
+    memcpy(u.value, data, bytes);
+    u.bytes = bytes;
+    u.hasValue = true;
+    return true;
+}
+
+void ShaderProgram::setInt(int handle, GLint value)
+{
+    if (changed(handle, &value, sizeof(value)))
+    {
+        glUniform1i(uniforms[handle].location, value);
+    }
+}
+
+void ShaderProgram::setFloat(int handle, GLfloat value)
+{
+    if (changed(handle, &value, sizeof(value)))
+    {
+        glUniform1f(uniforms[handle].location, value);
+    }
+}
+
+void ShaderProgram::setVec2(int handle, const glm::vec2 &value)
+{
+    if (changed(handle, &value, sizeof(value)))
+    {
+        glUniform2f(uniforms[handle].location, value.x, value.y);
+    }
+}
+
+void ShaderProgram::setVec3(int handle, const glm::vec3 &value)
+{
+    if (changed(handle, &value, sizeof(value)))
+    {
+        glUniform3f(uniforms[handle].location, value.x, value.y, value.z);
+    }
+}
+
+void ShaderProgram::setVec4(int handle, const glm::vec4 &value)
+{
+    if (changed(handle, &value, sizeof(value)))
+    {
+        glUniform4f(uniforms[handle].location, value.x, value.y, value.z, value.w);
+    }
+}
+
+void ShaderProgram::setMat4(int handle, const glm::mat4 &value)
+{
+    if (changed(handle, &value, sizeof(value)))
+    {
+        glUniformMatrix4fv(uniforms[handle].location, 1, GL_FALSE, &value[0][0]);
+    }
+}
+
+void ShaderProgram::send(const Uniform &u)
+{
+    const GLfloat *v = u.value;
+    switch (u.bytes)
+    {
+    case sizeof(GLfloat):
+        if (u.type == GL_FLOAT)
+        {
+            glUniform1f(u.location, v[0]);
+        }
+        else
+        {
+            glUniform1i(u.location, *(const GLint *)v);
+        }
+        break;
+    case sizeof(glm::vec2):
+        glUniform2f(u.location, v[0], v[1]);
+        break;
+    case sizeof(glm::vec3):
+        glUniform3f(u.location, v[0], v[1], v[2]);
+        break;
+    case sizeof(glm::vec4):
+        glUniform4f(u.location, v[0], v[1], v[2], v[3]);
+        break;
+    case sizeof(glm::mat4):
+        glUniformMatrix4fv(u.location, 1, GL_FALSE, v);
+        break;
+    }
+}
+
+void ShaderProgram::invalidate()
+{
+    for (Uniform &u : uniforms)
+    {
+        u.hasValue = false;
+    }
+}
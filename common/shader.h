@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "gl_state.h"
+
+// Compila e "builda" um programa de shader a partir do código fonte GLSL do
+// vertex e do fragment shader. Erros de compilação e linkagem são exibidos no
+// terminal. A função retorna o identificador do programa de shader
+// Se o programa já estiver no cache de binários (programcache), nada é compilado
+GLuint setupShader(const GLchar *vsSource, const GLchar *fsSource);
+
+// Programa de shader com a tabela de uniforms ativos montada uma única vez, logo
+// após a linkagem. uniform() devolve um handle já resolvido (ou -1 se o uniform
+// não existe ou foi otimizado pelo driver); os setters recebem esse handle e só
+// chamam glUniform* quando o valor é diferente do último enviado
+// Como a GLAD está na versão 4.0 (sem glProgramUniform*), o programa precisa
+// estar em uso (use()) quando um setter é chamado
+class ShaderProgram
+{
+public:
+    ShaderProgram() = default;
+    ShaderProgram(const GLchar *vsSource, const GLchar *fsSource);
+
+    // Programa lido de arquivos GLSL (ver shadersource), que pode ser recarregado
+    static ShaderProgram fromFiles(const std::string &vsPath, const std::string &fsPath);
+
+    // Lê os arquivos de novo e relinka. Os handles de uniform continuam válidos e os
+    // valores já enviados são reenviados ao novo programa. Com erro, o programa
+    // anterior é mantido e a função retorna false
+    bool reload();
+    // Arquivos usados pelo último reload (incluindo os #include)
+    const std::vector<std::string> &files() const { return sources; }
+
+    GLuint id() const { return ID; }
+    void use() const { glstate::useProgram(ID); }
+
+    // Busca por nome: deve ser feita fora do game loop, guardando o handle
+    int uniform(const std::string &name) const;
+
+    void setInt(int handle, GLint value);
+    void setFloat(int handle, GLfloat value);
+    void setVec2(int handle, const glm::vec2 &value);
+    void setVec3(int handle, const glm::vec3 &value);
+    void setVec4(int handle, const glm::vec4 &value);
+    void setMat4(int handle, const glm::mat4 &value);
+
+    // Esquece os valores enviados (ex.: depois de um glUniform* feito por fora)
+    void invalidate();
+
+private:
+    struct Uniform
+    {
+        GLint location;
+        GLenum type;
+        GLint size;           // número de elementos (arrays)
+        GLfloat value[16];    // último valor enviado do primeiro elemento
+        size_t bytes = 0;     // tamanho do valor (diz qual glUniform* o enviou)
+        bool hasValue = false;
+    };
+
+    void reflectUniforms();
+    // Compara com o valor guardado e atualiza o cache; retorna true se é preciso enviar
+    bool changed(int handle, const void *data, size_t bytes);
+    // Reenvia o valor guardado (o programa precisa estar em uso)
+    void send(const Uniform &u);
+
+    GLuint ID = 0;
+    std::vector<Uniform> uniforms;
+    std::unordered_map<std::string, int> handles;
+
+    std::string vsPath, fsPath;       // vazios para programas criados a partir de strings
+    std::vector<std::string> sources;
+};
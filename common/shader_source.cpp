@@ -0,0 +1,128 @@
+#include "shader_source.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef ENGINE_SHADER_DIR
+#define ENGINE_SHADER_DIR "shaders"
+#endif
+
+namespace
+{
+    std::string shaderDirectory = ENGINE_SHADER_DIR;
+
+    // Inclusões mais profundas que isso são tratadas como ciclo
+    const int MAX_INCLUDE_DEPTH = 16;
+
+    bool readFile(const std::string &path, std::string &text)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        text = buffer.str();
+        return true;
+    }
+
+    // Se a linha é um #include "arquivo", devolve o nome do arquivo em name
+    bool parseInclude(const std::string &line, std::string &name)
+    {
+        size_t p = line.find_first_not_of(" \t");
+        if (p == std::string::npos || line.compare(p, 8, "#include") != 0)
+        {
+            return false;
+        }
+        size_t open = line.find('"', p + 8);
+        size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos)
+        {
+            return false;
+        }
+        name = line.substr(open + 1, close - open - 1);
+        return true;
+    }
+
+    bool expand(const std::string &path, std::string &source, std::vector<std::string> &files, int depth)
+    {
+        if (depth > MAX_INCLUDE_DEPTH)
+        {
+            std::cout << "ERROR::SHADER::INCLUDE_TOO_DEEP " << path << std::endl;
+            return false;
+        }
+
+        // Já incluído neste shader
+        if (std::find(files.begin(), files.end(), path) != files.end())
+        {
+            return true;
+        }
+
+        std::string text;
+        if (!readFile(path, text))
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_FOUND " << path << std::endl;
+            return false;
+        }
+        int fileIndex = (int)files.size();
+        files.push_back(path);
+        if (depth > 0)
+        {
+            source += "#line 1 " + std::to_string(fileIndex) + "\n";
+        }
+
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        std::istringstream lines(text);
+        std::string line, name;
+        int lineNumber = 0;
+        while (std::getline(lines, line))
+        {
+            lineNumber++;
+            if (!parseInclude(line, name))
+            {
+                source += line;
+                source += '\n';
+                continue;
+            }
+
+            if (!expand((parent / name).lexically_normal().string(), source, files, depth + 1))
+            {
+                std::cout << "  included from " << path << ":" << lineNumber << std::endl;
+                return false;
+            }
+            source += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n";
+        }
+        return true;
+    }
+}
+
+void shadersource::setDirectory(const std::string &directory)
+{
+    shaderDirectory = directory;
+}
+
+const std::string &shadersource::directory()
+{
+    return shaderDirectory;
+}
+
+std::string shadersource::resolve(const std::string &path)
+{
+    std::filesystem::path p(path);
+    if (p.is_absolute() || shaderDirectory.empty())
+    {
+        return p.lexically_normal().string();
+    }
+    return (std::filesystem::path(shaderDirectory) / p).lexically_normal().string();
+}
+
+bool shadersource::load(const std::string &path, std::string &source, std::vector<std::string> &files)
+{
+    source.clear();
+    files.clear();
+    return expand(resolve(path), source, files, 0);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Leitura de shaders GLSL de arquivos, com #include "arquivo" resolvido em relação
+// ao arquivo que inclui. Cada arquivo entra uma única vez por shader (como um
+// #pragma once) e depois de cada trecho incluído vem uma diretiva #line, para os
+// erros do compilador apontarem a linha certa; o número de "fonte" da diretiva é
+// a posição do arquivo na lista devolvida em files
+// Caminhos relativos partem do diretório de shaders: por padrão o shaders/ do
+// repositório (ENGINE_SHADER_DIR, definido pelo CMake)
+namespace shadersource
+{
+    void setDirectory(const std::string &directory);
+    const std::string &directory();
+
+    // Caminho relativo ao diretório de shaders (caminhos absolutos ficam como estão)
+    std::string resolve(const std::string &path);
+
+    // Monta o código completo em source e lista em files os arquivos usados (o
+    // principal primeiro). Retorna false, com a mensagem no terminal, se algum
+    // arquivo não puder ser lido
+    bool load(const std::string &path, std::string &source, std::vector<std::string> &files);
+}
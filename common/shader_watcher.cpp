@@ -0,0 +1,181 @@
+#include "shader_watcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+#if defined(ENGINE_SHADER_HOT_RELOAD) && defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#define WATCHER_INOTIFY 1
+#endif
+
+namespace
+{
+    // Sem inotify, intervalo entre duas conferências das datas de modificação
+    const double SCAN_INTERVAL = 0.5;
+
+    double now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    long long modificationTime(const std::string &path)
+    {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+        return error ? 0 : (long long)time.time_since_epoch().count();
+    }
+}
+
+ShaderWatcher::ShaderWatcher()
+{
+#ifdef WATCHER_INOTIFY
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cout << "WARNING::SHADER_WATCHER::INOTIFY_FAILED, falling back to polling" << std::endl;
+    }
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+#ifdef WATCHER_INOTIFY
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+#endif
+}
+
+void ShaderWatcher::watch(ShaderProgram &program)
+{
+#ifdef ENGINE_SHADER_HOT_RELOAD
+    if (std::find(programs.begin(), programs.end(), &program) == programs.end())
+    {
+        programs.push_back(&program);
+    }
+    addDirectories(program);
+#else
+    (void)program;
+#endif
+}
+
+void ShaderWatcher::addDirectories(const ShaderProgram &program)
+{
+    for (const std::string &file : program.files())
+    {
+        if (fd < 0)
+        {
+            bool known = std::any_of(stamps.begin(), stamps.end(), [&file](const auto &s) { return s.first == file; });
+            if (!known)
+            {
+                stamps.emplace_back(file, modificationTime(file));
+            }
+            continue;
+        }
+
+        std::string directory = std::filesystem::path(file).parent_path().string();
+        if (std::find(directories.begin(), directories.end(), directory) != directories.end())
+        {
+            continue;
+        }
+#ifdef WATCHER_INOTIFY
+        // Diretório em vez de arquivo: salvar com "escreve num temporário e renomeia"
+        // troca o inode do arquivo, e um watch no arquivo antigo pararia de disparar
+        int wd = inotify_add_watch(fd, directory.empty() ? "." : directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0)
+        {
+            std::cout << "WARNING::SHADER_WATCHER::WATCH_FAILED " << directory << std::endl;
+            continue;
+        }
+        directories.push_back(directory);
+        watches.push_back(wd);
+#endif
+    }
+}
+
+bool ShaderWatcher::uses(const ShaderProgram &program, const std::string &path) const
+{
+    const std::vector<std::string> &files = program.files();
+    return std::find(files.begin(), files.end(), path) != files.end();
+}
+
+int ShaderWatcher::poll()
+{
+#ifndef ENGINE_SHADER_HOT_RELOAD
+    return 0;
+#else
+    changed.clear();
+
+#ifdef WATCHER_INOTIFY
+    if (fd >= 0)
+    {
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char *p = buffer; p < buffer + length;)
+            {
+                const inotify_event *event = (const inotify_event *)p;
+                p += sizeof(inotify_event) + event->len;
+
+                auto it = std::find(watches.begin(), watches.end(), event->wd);
+                if (it == watches.end() || event->len == 0)
+                {
+                    continue;
+                }
+                std::filesystem::path directory(directories[it - watches.begin()]);
+                changed.push_back((directory / event->name).lexically_normal().string());
+            }
+        }
+    }
+#endif
+
+    if (fd < 0 && now() - lastScan >= SCAN_INTERVAL)
+    {
+        lastScan = now();
+        for (auto &stamp : stamps)
+        {
+            long long time = modificationTime(stamp.first);
+            if (time != stamp.second)
+            {
+                stamp.second = time;
+                changed.push_back(stamp.first);
+            }
+        }
+    }
+
+    int reloaded = 0;
+    if (changed.empty())
+    {
+        return reloaded;
+    }
+
+    for (ShaderProgram *program : programs)
+    {
+        bool dirty = std::any_of(changed.begin(), changed.end(),
+                                 [&](const std::string &path) { return uses(*program, path); });
+        if (!dirty)
+        {
+            continue;
+        }
+
+        const std::string name = program->files().empty() ? std::string() : program->files().front();
+        if (program->reload())
+        {
+            std::cout << "Shader reloaded: " << name << std::endl;
+            reloaded++;
+        }
+        else
+        {
+            std::cout << "Shader reload failed, keeping the previous program: " << name << std::endl;
+        }
+        // O reload pode ter trazido #include novos
+        addDirectories(*program);
+    }
+    return reloaded;
+#endif
+}
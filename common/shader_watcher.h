@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "shader.h"
+
+// Recarrega programas de shader quando um dos arquivos deles muda no disco, sem
+// reiniciar o executável. No Linux os diretórios dos arquivos são observados com
+// inotify (o que também pega editores que salvam num arquivo novo e renomeiam);
+// nas outras plataformas a data de modificação é conferida a cada meio segundo
+// Só existe em builds de desenvolvimento (opção ENGINE_SHADER_HOT_RELOAD do CMake);
+// sem ela, watch() e poll() não fazem nada
+// Os programas são guardados por ponteiro: não podem mudar de endereço enquanto
+// estiverem sendo observados
+class ShaderWatcher
+{
+public:
+    ShaderWatcher();
+    ~ShaderWatcher();
+    ShaderWatcher(const ShaderWatcher &) = delete;
+    ShaderWatcher &operator=(const ShaderWatcher &) = delete;
+
+    void watch(ShaderProgram &program);
+
+    // Chamar uma vez por frame, na thread do contexto OpenGL: recarrega os
+    // programas com arquivos alterados e retorna quantos foram recarregados
+    int poll();
+
+private:
+    void addDirectories(const ShaderProgram &program);
+    bool uses(const ShaderProgram &program, const std::string &path) const;
+
+    std::vector<ShaderProgram *> programs;
+    std::vector<std::string> directories;
+    std::vector<int> watches;        // descritor inotify de cada diretório
+    std::vector<std::string> changed; // arquivos alterados desde o último poll
+    int fd = -1;
+    double lastScan = 0.0;
+    std::vector<std::pair<std::string, long long>> stamps; // sem inotify: arquivo e data
+};
@@ -0,0 +1,322 @@
+#include "sprite_batch.h"
+#include "gl_state.h"
+#include "transform_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void SpriteBatch::init(int maxSprites, bool flipV)
+{
+    this->capacity = maxSprites;
+    this->flipV = flipV;
+
+    shader = ShaderProgram::fromFiles("sprite_batch.vert", "textured.frag");
+    projectionLoc = shader.uniform("projection");
+    shader.use();
+    shader.setInt(shader.uniform("tex_buff"), 0);
+
+    cutoutShader = ShaderProgram::fromFiles("sprite_batch.vert", "textured_cutout.frag");
+    cutoutProjectionLoc = cutoutShader.uniform("projection");
+    cutoutShader.use();
+    cutoutShader.setInt(cutoutShader.uniform("tex_buff"), 0);
+    cutoutShader.setFloat(cutoutShader.uniform("alphaCutoff"), 0.5f);
+
+    // Índices fixos: dois triângulos por sprite (V0 V1 V2, V2 V1 V3)
+    std::vector<GLuint> indices(capacity * 6);
+    for (int i = 0; i < capacity; i++)
+    {
+        GLuint v = i * 4;
+        indices[i * 6 + 0] = v + 0;
+        indices[i * 6 + 1] = v + 1;
+        indices[i * 6 + 2] = v + 2;
+        indices[i * 6 + 3] = v + 2;
+        indices[i * 6 + 4] = v + 1;
+        indices[i * 6 + 5] = v + 3;
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glstate::bindVertexArray(VAO);
+
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+
+    // O EBO fica registrado no VAO
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+    // Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    // Ponteiro pro atributo 1 - Coordenada de textura s, t
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *)(3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glstate::bindVertexArray(0);
+
+    sprites.reserve(capacity);
+    modes.reserve(capacity);
+    order.reserve(capacity);
+}
+
+void SpriteBatch::setProjection(const glm::mat4 &projection)
+{
+    shader.use();
+    shader.setMat4(projectionLoc, projection);
+    cutoutShader.use();
+    cutoutShader.setMat4(cutoutProjectionLoc, projection);
+}
+
+void SpriteBatch::begin()
+{
+    sprites.clear();
+    modes.clear();
+    translucent.clear();
+    lastDrawCalls = 0;
+}
+
+void SpriteBatch::draw(const BatchSprite &sprite)
+{
+    sprites.push_back(sprite);
+    modes.push_back(textureAlpha(sprite.texID));
+}
+
+void SpriteBatch::draw(const BatchSprite &sprite, const TextureRegion &region)
+{
+    sprites.push_back(sprite);
+    sprites.back().texID = region.texID;
+    sprites.back().uvRect = region.uvRect;
+    // A página do atlas mistura imagens: vale a classificação da região
+    modes.push_back(region.alpha);
+}
+
+void SpriteBatch::end()
+{
+    endOpaque();
+    endTranslucent();
+}
+
+void SpriteBatch::endOpaque()
+{
+    if (sprites.empty())
+    {
+        return;
+    }
+
+    // Ordena por camada e, dentro da camada, por textura. A ordenação estável
+    // mantém a ordem de submissão entre sprites iguais (ordem de pintura)
+    order.resize(sprites.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+                     {
+                         const BatchSprite &sa = sprites[a], &sb = sprites[b];
+                         if (sa.layer != sb.layer)
+                         {
+                             return sa.layer < sb.layer;
+                         }
+                         return sa.texID < sb.texID;
+                     });
+
+    if (!depthSorting)
+    {
+        drawList(order);
+        return;
+    }
+
+    // A posição na ordem de pintura vira profundidade: com o teste de profundidade,
+    // qualquer ordem de desenho dá o mesmo resultado que pintar nessa ordem. O passo
+    // divide o espaço entre o maior position.z e o plano near (z = 1) pelos sprites
+    // do frame, então o último da ordem ainda fica dentro do volume de visão
+    float maxZ = 0.0f;
+    bool outside = false;
+    for (const BatchSprite &sprite : sprites)
+    {
+        maxZ = std::max(maxZ, sprite.position.z);
+        outside = outside || sprite.position.z < -1.0f || sprite.position.z >= 1.0f;
+    }
+    if (outside && !warnedDepthRange)
+    {
+        std::cout << "SpriteBatch: sprite z outside [-1, 1) with depth sorting, clamping to the view volume"
+                  << std::endl;
+        warnedDepthRange = true;
+    }
+    float step = std::max(1.0f - maxZ, 0.0f) / (float)(sprites.size() + 1);
+
+    depths.resize(sprites.size());
+    opaque.clear();
+    translucent.clear();
+    for (size_t rank = 0; rank < order.size(); rank++)
+    {
+        size_t index = order[rank];
+        depths[index] = std::min(std::max(sprites[index].position.z + (float)(rank + 1) * step, -1.0f), 1.0f);
+        (modes[index] == AlphaMode::Translucent ? translucent : opaque).push_back(index);
+    }
+
+    // Da frente para trás: camadas de cima primeiro e, dentro da camada, agrupados
+    // por programa e textura; entre sprites do mesmo grupo, o de maior posição na
+    // ordem de pintura (o da frente) vai antes
+    std::stable_sort(opaque.begin(), opaque.end(), [this](size_t a, size_t b)
+                     {
+                         const BatchSprite &sa = sprites[a], &sb = sprites[b];
+                         if (sa.layer != sb.layer)
+                         {
+                             return sa.layer > sb.layer;
+                         }
+                         if (modes[a] != modes[b])
+                         {
+                             return modes[a] < modes[b];
+                         }
+                         if (sa.texID != sb.texID)
+                         {
+                             return sa.texID < sb.texID;
+                         }
+                         return depths[a] > depths[b];
+                     });
+
+    glstate::enable(GL_DEPTH_TEST);
+    glstate::depthFunc(GL_LESS);
+    glstate::depthMask(GL_TRUE);
+    glstate::disable(GL_BLEND);
+    drawList(opaque);
+}
+
+void SpriteBatch::endTranslucent()
+{
+    if (translucent.empty())
+    {
+        return;
+    }
+
+    // Já estão na ordem de pintura, de trás para frente. Sem escrever profundidade,
+    // dois translúcidos sobrepostos se misturam; atrás de um opaco, são rejeitados
+    glstate::enable(GL_DEPTH_TEST);
+    glstate::depthFunc(GL_LESS);
+    glstate::depthMask(GL_FALSE);
+    glstate::enable(GL_BLEND);
+    glstate::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    drawList(translucent);
+
+    // O glClear do próximo frame só limpa a profundidade com a escrita ligada
+    glstate::depthMask(GL_TRUE);
+    translucent.clear();
+}
+
+void SpriteBatch::drawList(const std::vector<size_t> &list)
+{
+    glstate::activeTexture(GL_TEXTURE0);
+    glstate::bindVertexArray(VAO);
+
+    // Se houver mais sprites que a capacidade do VBO, desenha em blocos
+    for (size_t first = 0; first < list.size(); first += capacity)
+    {
+        size_t count = std::min(list.size() - first, (size_t)capacity);
+        flush(list, first, count);
+    }
+}
+
+void SpriteBatch::flush(const std::vector<size_t> &list, size_t first, size_t count)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    // Orfana o buffer: o driver entrega memória nova em vez de sincronizar com a
+    // GPU, que ainda pode estar lendo os vértices do flush anterior
+    glBufferData(GL_ARRAY_BUFFER, capacity * 4 * sizeof(Vertex), NULL, GL_STREAM_DRAW);
+    Vertex *vertices = (Vertex *)glMapBufferRange(GL_ARRAY_BUFFER, 0, count * 4 * sizeof(Vertex),
+                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!vertices)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    // Posição, tamanho e rotação dos sprites do bloco em arrays separados, para o
+    // kernel vetorizado calcular os cantos de vários sprites por instrução
+    px.resize(count);
+    py.resize(count);
+    width.resize(count);
+    height.resize(count);
+    cosR.resize(count);
+    sinR.resize(count);
+    corners.resize(count * 8);
+    for (size_t n = 0; n < count; n++)
+    {
+        const BatchSprite &sprite = sprites[list[first + n]];
+        px[n] = sprite.position.x;
+        py[n] = sprite.position.y;
+        width[n] = sprite.dimensions.x;
+        height[n] = sprite.dimensions.y;
+        // A maioria dos sprites não gira: evita cos e sin
+        cosR[n] = sprite.rotation != 0.0f ? cos(sprite.rotation) : 1.0f;
+        sinR[n] = sprite.rotation != 0.0f ? sin(sprite.rotation) : 0.0f;
+    }
+    transform::quadCorners(px.data(), py.data(), width.data(), height.data(), cosR.data(), sinR.data(), count,
+                           corners.data());
+
+    // Cantos do quadrado unitário na mesma ordem de setupSprite (V0 V1 V2 V3)
+    static const float unitCorners[4][2] = {{-0.5f, 0.5f}, {-0.5f, -0.5f}, {0.5f, 0.5f}, {0.5f, -0.5f}};
+
+    for (size_t n = 0; n < count; n++)
+    {
+        size_t index = list[first + n];
+        const BatchSprite &sprite = sprites[index];
+        const float *xy = &corners[n * 8];
+        float z = depthSorting ? depths[index] : sprite.position.z;
+
+        for (int k = 0; k < 4; k++)
+        {
+            // Mesma coordenada de textura que o shader dos exercícios calculava
+            float u = (unitCorners[k][0] + 0.5f) * sprite.ds;
+            float v = (unitCorners[k][1] + 0.5f) * sprite.dt;
+            if (flipV)
+            {
+                v = 1.0f - v;
+            }
+
+            Vertex &out = vertices[n * 4 + k];
+            out.x = xy[k * 2 + 0];
+            out.y = xy[k * 2 + 1];
+            out.z = z;
+            // Coordenada local da imagem levada para o retângulo dela na textura
+            out.s = sprite.uvRect.x + (u + sprite.offsetTex.s) * sprite.uvRect.z;
+            out.t = sprite.uvRect.y + (v + sprite.offsetTex.t) * sprite.uvRect.w;
+        }
+    }
+
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Uma chamada de desenho por sequência de sprites com a mesma textura e o mesmo
+    // programa (os recortes descartam os texels transparentes)
+    auto programOf = [this](size_t index) -> ShaderProgram &
+    {
+        return depthSorting && modes[index] == AlphaMode::Cutout ? cutoutShader : shader;
+    };
+    size_t runStart = 0;
+    while (runStart < count)
+    {
+        size_t index = list[first + runStart];
+        GLuint texID = sprites[index].texID;
+        ShaderProgram &program = programOf(index);
+        size_t runEnd = runStart + 1;
+        while (runEnd < count && sprites[list[first + runEnd]].texID == texID &&
+               &programOf(list[first + runEnd]) == &program)
+        {
+            runEnd++;
+        }
+
+        program.use();
+        glstate::bindTexture(GL_TEXTURE_2D, texID);
+        glDrawElements(GL_TRIANGLES, (GLsizei)((runEnd - runStart) * 6), GL_UNSIGNED_INT,
+                       (GLvoid *)(runStart * 6 * sizeof(GLuint)));
+        lastDrawCalls++;
+
+        runStart = runEnd;
+    }
+}
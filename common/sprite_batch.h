@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+#include "texture_atlas.h"
+
+// Um sprite enviado ao SpriteBatch: mesmos campos do struct Sprite dos exercícios
+struct BatchSprite
+{
+    glm::vec3 position;        // centro do sprite
+    glm::vec3 dimensions;      // tamanho do frame na tela
+    GLuint texID;
+    glm::vec2 offsetTex;       // deslocamento do frame (iFrame * ds, iAnimation * dt)
+    float ds = 1.0f, dt = 1.0f; // tamanho de um frame em coordenadas de textura
+    float rotation = 0.0f;     // em radianos, em torno do centro
+    int layer = 0;             // camadas menores são desenhadas primeiro
+    // Retângulo da imagem dentro da textura (s0, t0, largura, altura): com um
+    // TextureAtlas, vários sprites compartilham a mesma textura e o mesmo draw
+    glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+};
+
+// Desenha muitos sprites com poucas chamadas de desenho: os sprites de um frame
+// são ordenados por camada e textura, os vértices são escritos em um único VBO de
+// streaming (órfão a cada flush, para não esperar a GPU terminar o frame anterior)
+// e cada sequência de sprites com a mesma textura vira um único glDrawElements
+// Dentro de uma mesma camada a ordem entre texturas não é garantida: sprites que
+// se sobrepõem e dependem da ordem de pintura devem estar em camadas diferentes
+// Uso: init() uma vez (com contexto OpenGL), e a cada frame begin(), draw()... e end()
+//
+// Com setDepthSorting(true) o batch funciona como uma fila de renderização com teste
+// de profundidade de verdade. Cada sprite recebe uma profundidade pela sua posição
+// na ordem de pintura (quem seria pintado depois fica na frente): position.z mais um
+// passo por posição, calculado a cada frame para que todos caibam abaixo de z = 1.
+// Ele também é classificado pelo alpha da textura ou da região do atlas (texture_alpha.h):
+//   endOpaque()      - opacos e recortes da frente para trás, sem blending e
+//                      escrevendo profundidade: o que fica atrás é rejeitado pelo
+//                      early-Z antes de rodar o fragment shader
+//   endTranslucent() - translúcidos de trás para frente, com blending, testando mas
+//                      sem escrever profundidade
+// Entre as duas dá para desenhar o que fica atrás de todos os sprites (ex.: o
+// tilemap, em z = 0), que também é rejeitado onde um sprite opaco já cobriu a tela.
+// end() chama as duas. A projeção precisa manter z de -1 a 1 dentro do volume de
+// visão (ex.: ortho com near -1 e far 1; z fora disso é limitado a esse intervalo,
+// com um aviso no terminal); o framebuffer precisa de profundidade,
+// limpa a cada frame. As passadas ajustam teste de profundidade, depthMask e
+// blending, e deixam depthMask ligado no fim
+class SpriteBatch
+{
+public:
+    // flipV reproduz o "1.0 - texc.t" dos shaders com projeção de y para cima
+    void init(int maxSprites = 4096, bool flipV = true);
+    void setProjection(const glm::mat4 &projection);
+
+    // Ordenação por profundidade em passadas de opacos e translúcidos (desligada: a
+    // ordem de pintura de sempre, tudo com blending)
+    void setDepthSorting(bool enabled) { depthSorting = enabled; }
+    bool depthSorts() const { return depthSorting; }
+
+    void begin();
+    void draw(const BatchSprite &sprite);
+    // Atalho para um sprite que ocupa uma região do atlas
+    void draw(const BatchSprite &sprite, const TextureRegion &region);
+    void end();
+    // As duas metades de end(), para desenhar outra coisa entre elas. Sem a ordenação
+    // por profundidade, endOpaque() desenha todos os sprites
+    void endOpaque();
+    void endTranslucent();
+
+    bool flipsV() const { return flipV; }
+
+    // Chamadas de desenho emitidas pelo último end()
+    int drawCalls() const { return lastDrawCalls; }
+
+    // Programa do batch (shaders/sprite_batch.vert), ex.: para um ShaderWatcher
+    ShaderProgram &program() { return shader; }
+    // Programa dos recortes na ordenação por profundidade (shaders/textured_cutout.frag)
+    ShaderProgram &cutoutProgram() { return cutoutShader; }
+
+private:
+    struct Vertex
+    {
+        GLfloat x, y, z;
+        GLfloat s, t;
+    };
+
+    void drawList(const std::vector<size_t> &list);
+    void flush(const std::vector<size_t> &list, size_t first, size_t count);
+
+    ShaderProgram shader;
+    ShaderProgram cutoutShader;
+    int projectionLoc = -1;
+    int cutoutProjectionLoc = -1;
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    int capacity = 0;
+    bool flipV = true;
+    int lastDrawCalls = 0;
+    bool depthSorting = false;
+    bool warnedDepthRange = false;
+
+    std::vector<BatchSprite> sprites;
+    std::vector<AlphaMode> modes;   // um por sprite
+    std::vector<float> depths;      // z final (position.z mais a ordem de pintura), um por sprite
+    std::vector<size_t> order;      // ordem de pintura
+    std::vector<size_t> opaque;     // opacos e recortes, da frente para trás
+    std::vector<size_t> translucent; // de trás para frente, até endTranslucent()
+
+    // Entrada e saída de transform::quadCorners, reaproveitadas entre flushes
+    std::vector<float> px, py, width, height, cosR, sinR;
+    std::vector<float> corners;
+};
@@ -0,0 +1,137 @@
+#include "texture.h"
+#include "gl_state.h"
+#include "texture_alpha.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// STB_IMAGE
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// Cria a textura a partir dos pixels já decodificados (ou vazia, se data for nullptr)
+static GLuint createTexture(const unsigned char *data, int width, int height, int nrChannels, GLint filter)
+{
+    GLuint texID;
+
+    // Gera o identificador da textura na memória
+    glGenTextures(1, &texID);
+    glstate::bindTexture(GL_TEXTURE_2D, texID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+    if (data)
+    {
+        if (nrChannels == 3) // jpg, bmp
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        }
+        else // png
+        {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    setTextureAlpha(texID, classifyAlpha(data, width, height, nrChannels));
+
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+
+    return texID;
+}
+
+GLuint loadTexture(const std::string &filePath, int &width, int &height, GLint filter)
+{
+    int nrChannels;
+
+    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+    if (!data)
+    {
+        std::cout << "Failed to load texture " << filePath << std::endl;
+    }
+
+    GLuint texID = createTexture(data, width, height, nrChannels, filter);
+    stbi_image_free(data);
+
+    return texID;
+}
+
+GLuint loadTextureFromMemory(const unsigned char *buffer, size_t size, int &width, int &height, int &nrChannels,
+                             GLint filter)
+{
+    unsigned char *data = stbi_load_from_memory(buffer, (int)size, &width, &height, &nrChannels, 0);
+    if (!data)
+    {
+        std::cout << "Failed to decode texture from memory" << std::endl;
+        width = height = nrChannels = 0;
+    }
+
+    GLuint texID = createTexture(data, width, height, nrChannels, filter);
+    stbi_image_free(data);
+
+    return texID;
+}
+
+GLuint loadTexture(const std::string &filePath, GLint filter)
+{
+    int width, height;
+    return loadTexture(filePath, width, height, filter);
+}
+
+GLuint loadTextureArray(const std::string &filePath, int nAnimations, int nFrames, int &frameWidth, int &frameHeight,
+                        GLint filter)
+{
+    frameWidth = frameHeight = 0;
+    int width, height, nrChannels;
+    // Sempre RGBA: todas as camadas do array têm o mesmo formato
+    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 4);
+    if (!data || nAnimations <= 0 || nFrames <= 0)
+    {
+        std::cout << "Failed to load texture " << filePath << std::endl;
+        stbi_image_free(data);
+        return 0;
+    }
+
+    frameWidth = width / nFrames;
+    frameHeight = height / nAnimations;
+    int layers = nAnimations * nFrames;
+
+    // Copia cada frame para um bloco contíguo (uma camada), na mesma ordem de linhas da imagem
+    size_t frameBytes = (size_t)frameWidth * frameHeight * 4;
+    std::vector<unsigned char> slices(frameBytes * layers);
+    for (int row = 0; row < nAnimations; row++)
+    {
+        for (int column = 0; column < nFrames; column++)
+        {
+            unsigned char *layer = slices.data() + (row * nFrames + column) * frameBytes;
+            for (int y = 0; y < frameHeight; y++)
+            {
+                const unsigned char *src = data + (((size_t)row * frameHeight + y) * width + column * frameWidth) * 4;
+                std::copy(src, src + frameWidth * 4, layer + (size_t)y * frameWidth * 4);
+            }
+        }
+    }
+    stbi_image_free(data);
+
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glstate::bindTexture(GL_TEXTURE_2D_ARRAY, texID);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, filter);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, frameWidth, frameHeight, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 slices.data());
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    setTextureAlpha(texID, classifyAlpha(slices.data(), frameWidth, frameHeight * layers, 4));
+
+    glstate::bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    return texID;
+}
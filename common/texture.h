@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <glad/glad.h>
+
+// Carrega uma imagem (jpg, bmp ou png) do disco e cria uma textura 2D com mipmaps
+// O filtro padrão é GL_NEAREST (pixel art); passe GL_LINEAR para suavizar
+// A função retorna o identificador da textura e, na primeira versão, as dimensões da imagem
+GLuint loadTexture(const std::string &filePath, int &width, int &height, GLint filter = GL_NEAREST);
+GLuint loadTexture(const std::string &filePath, GLint filter = GL_NEAREST);
+
+// Mesma coisa, mas decodificando um arquivo de imagem já lido para a memória
+// nrChannels devolve o número de canais da imagem (3 = RGB, 4 = RGBA)
+GLuint loadTextureFromMemory(const unsigned char *buffer, size_t size, int &width, int &height, int &nrChannels,
+                             GLint filter = GL_NEAREST);
+
+// Fatia uma spritesheet com nAnimations linhas e nFrames colunas em uma
+// GL_TEXTURE_2D_ARRAY com um frame por camada: camada = linha * nFrames + coluna,
+// com as linhas contadas de cima para baixo na imagem. Como cada frame é uma camada
+// separada (GL_CLAMP_TO_EDGE), o filtro e os mipmaps não misturam frames vizinhos
+// frameWidth e frameHeight recebem o tamanho de um frame em pixels
+GLuint loadTextureArray(const std::string &filePath, int nAnimations, int nFrames, int &frameWidth, int &frameHeight,
+                        GLint filter = GL_NEAREST);
@@ -0,0 +1,61 @@
+#include "texture_alpha.h"
+
+#include <cstddef>
+#include <unordered_map>
+
+namespace
+{
+    const int ALPHA_TOLERANCE = 5;
+
+    // Só acessado pela thread da OpenGL (onde as texturas são criadas)
+    std::unordered_map<GLuint, AlphaMode> modes;
+}
+
+AlphaMode classifyAlpha(const unsigned char *pixels, int width, int height, int channels)
+{
+    if (!pixels || channels != 4)
+    {
+        return pixels && channels == 3 ? AlphaMode::Opaque : AlphaMode::Translucent;
+    }
+
+    AlphaMode mode = AlphaMode::Opaque;
+    size_t count = (size_t)width * height;
+    for (size_t i = 0; i < count; i++)
+    {
+        int alpha = pixels[i * 4 + 3];
+        if (alpha >= 255 - ALPHA_TOLERANCE)
+        {
+            continue;
+        }
+        if (alpha > ALPHA_TOLERANCE)
+        {
+            return AlphaMode::Translucent;
+        }
+        mode = AlphaMode::Cutout;
+    }
+    return mode;
+}
+
+void setTextureAlpha(GLuint texID, AlphaMode mode)
+{
+    modes[texID] = mode;
+}
+
+AlphaMode textureAlpha(GLuint texID)
+{
+    auto it = modes.find(texID);
+    return it == modes.end() ? AlphaMode::Translucent : it->second;
+}
+
+const char *alphaModeName(AlphaMode mode)
+{
+    switch (mode)
+    {
+    case AlphaMode::Opaque:
+        return "opaque";
+    case AlphaMode::Cutout:
+        return "cutout";
+    default:
+        return "translucent";
+    }
+}
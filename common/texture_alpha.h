@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+// Como uma imagem usa o canal alpha, decidido uma vez ao carregar:
+//   Opaque      - todo pixel opaco: pode escrever profundidade e dispensa o blending
+//   Cutout      - alpha só 0 ou 1 (pixel art com recorte): o transparente é
+//                 descartado no shader e o resto se comporta como opaco
+//   Translucent - alpha intermediário: precisa de blending, de trás para frente
+enum class AlphaMode : uint8_t
+{
+    Opaque,
+    Cutout,
+    Translucent
+};
+
+// Percorre os pixels (channels 3 = RGB, sempre opaco; 4 = RGBA). Valores de alpha
+// a até ALPHA_TOLERANCE de 0 ou de 255 contam como 0 ou 255
+AlphaMode classifyAlpha(const unsigned char *pixels, int width, int height, int channels);
+
+// Classificação das texturas criadas pela engine (loadTexture, TexturePack,
+// AsyncTextureLoader, TextureAtlas), por identificador. Textura desconhecida é
+// Translucent, o caso que funciona sempre
+void setTextureAlpha(GLuint texID, AlphaMode mode);
+AlphaMode textureAlpha(GLuint texID);
+
+// Nome para mensagens ("opaque", "cutout", "translucent")
+const char *alphaModeName(AlphaMode mode);
@@ -0,0 +1,213 @@
+#include "texture_atlas.h"
+#include "texture.h"
+#include "gl_state.h"
+
+#include <algorithm>
+#include <iostream>
+
+// A implementação da stb_image está em texture.cpp
+#include <stb_image.h>
+
+namespace
+{
+    struct PackImage
+    {
+        std::string path;
+        unsigned char *data;
+        int width, height;
+        int page, x, y; // posição do canto (já incluindo a borda) na página
+    };
+
+    // Copia a imagem para a página, repetindo os pixels da borda no espaço de padding
+    void blit(std::vector<unsigned char> &page, int pageWidth, const PackImage &image, int padding)
+    {
+        int paddedW = image.width + 2 * padding;
+        int paddedH = image.height + 2 * padding;
+        for (int y = 0; y < paddedH; y++)
+        {
+            int srcY = std::min(std::max(y - padding, 0), image.height - 1);
+            for (int x = 0; x < paddedW; x++)
+            {
+                int srcX = std::min(std::max(x - padding, 0), image.width - 1);
+                const unsigned char *src = image.data + (srcY * image.width + srcX) * 4;
+                unsigned char *dst = page.data() + ((image.y + y) * pageWidth + (image.x + x)) * 4;
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = src[3];
+            }
+        }
+    }
+}
+
+bool TextureAtlas::build(const std::vector<std::string> &filePaths, int pageSize, int padding, GLint filter)
+{
+    std::vector<PackImage> images;
+    bool ok = true;
+
+    for (const std::string &path : filePaths)
+    {
+        if (regions.count(path) || std::any_of(images.begin(), images.end(),
+                                               [&](const PackImage &image) { return image.path == path; }))
+        {
+            continue;
+        }
+
+        PackImage image;
+        int nrChannels;
+        image.path = path;
+        image.data = stbi_load(path.c_str(), &image.width, &image.height, &nrChannels, 4); // sempre RGBA
+        if (!image.data)
+        {
+            std::cout << "Failed to load texture " << path << std::endl;
+            ok = false;
+            continue;
+        }
+        if (image.width + 2 * padding > pageSize || image.height + 2 * padding > pageSize)
+        {
+            std::cout << "Texture " << path << " does not fit in a " << pageSize << "x" << pageSize
+                      << " atlas page" << std::endl;
+            stbi_image_free(image.data);
+            ok = false;
+            continue;
+        }
+        images.push_back(image);
+    }
+
+    // Prateleiras: as imagens mais altas primeiro, preenchendo linha a linha
+    std::vector<PackImage *> sorted;
+    for (PackImage &image : images)
+    {
+        sorted.push_back(&image);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const PackImage *a, const PackImage *b) { return a->height > b->height; });
+
+    // A altura de cada página é cortada para a parte realmente usada
+    std::vector<int> pageHeights;
+    int page = 0, x = 0, y = 0, shelfHeight = 0;
+    for (PackImage *image : sorted)
+    {
+        int paddedW = image->width + 2 * padding;
+        int paddedH = image->height + 2 * padding;
+
+        if (x + paddedW > pageSize) // nova prateleira
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        if (y + paddedH > pageSize) // nova página
+        {
+            pageHeights.push_back(y);
+            page++;
+            x = 0;
+            y = 0;
+            shelfHeight = 0;
+        }
+
+        image->page = page;
+        image->x = x;
+        image->y = y;
+        x += paddedW;
+        shelfHeight = std::max(shelfHeight, paddedH);
+    }
+
+    if (!images.empty())
+    {
+        pageHeights.push_back(y + shelfHeight);
+    }
+    int nPages = (int)pageHeights.size();
+
+    std::vector<std::vector<unsigned char>> pixels(nPages);
+    for (int i = 0; i < nPages; i++)
+    {
+        pixels[i].assign((size_t)pageSize * pageHeights[i] * 4, 0);
+    }
+    for (const PackImage &image : images)
+    {
+        blit(pixels[image.page], pageSize, image, padding);
+    }
+
+    // Envia as páginas para a GPU
+    size_t firstPage = pages.size();
+    for (int i = 0; i < nPages; i++)
+    {
+        GLuint texID;
+        glGenTextures(1, &texID);
+        glstate::bindTexture(GL_TEXTURE_2D, texID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter == GL_NEAREST ? GL_NEAREST : GL_LINEAR);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pageSize, pageHeights[i], 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels[i].data());
+        if (filter != GL_NEAREST && filter != GL_LINEAR)
+        {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        setTextureAlpha(texID, classifyAlpha(pixels[i].data(), pageSize, pageHeights[i], 4));
+        pages.push_back(texID);
+    }
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+
+    for (PackImage &image : images)
+    {
+        TextureRegion region;
+        region.texID = pages[firstPage + image.page];
+        float pageHeight = (float)pageHeights[image.page];
+        region.uvRect = glm::vec4((float)(image.x + padding) / pageSize, (float)(image.y + padding) / pageHeight,
+                                  (float)image.width / pageSize, (float)image.height / pageHeight);
+        region.width = image.width;
+        region.height = image.height;
+        region.alpha = classifyAlpha(image.data, image.width, image.height, 4);
+        regions[image.path] = region;
+
+        stbi_image_free(image.data);
+    }
+
+    return ok;
+}
+
+bool TextureAtlas::contains(const std::string &filePath) const
+{
+    return regions.count(filePath) != 0;
+}
+
+const TextureRegion &TextureAtlas::region(const std::string &filePath)
+{
+    auto it = regions.find(filePath);
+    if (it != regions.end())
+    {
+        return it->second;
+    }
+
+    // Fora do atlas: textura avulsa ocupando todo o espaço de coordenadas
+    TextureRegion region;
+    region.texID = loadTexture(filePath, region.width, region.height);
+    region.alpha = textureAlpha(region.texID);
+    return regions[filePath] = region;
+}
+
+void TextureAtlas::release()
+{
+    // As texturas avulsas carregadas por region() também pertencem ao atlas
+    for (auto &entry : regions)
+    {
+        if (std::find(pages.begin(), pages.end(), entry.second.texID) == pages.end())
+        {
+            glstate::forgetTexture(entry.second.texID);
+            glDeleteTextures(1, &entry.second.texID);
+        }
+    }
+    for (GLuint page : pages)
+    {
+        glstate::forgetTexture(page);
+    }
+    glDeleteTextures((GLsizei)pages.size(), pages.data());
+
+    pages.clear();
+    regions.clear();
+}
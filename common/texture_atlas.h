@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "texture_alpha.h"
+
+// Parte de uma textura: o identificador da textura (página do atlas ou textura
+// avulsa) e o retângulo de coordenadas de textura ocupado pela imagem
+// uvRect = (s0, t0, largura, altura); uma textura avulsa tem (0, 0, 1, 1)
+struct TextureRegion
+{
+    GLuint texID = 0;
+    glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    int width = 0, height = 0; // tamanho da imagem em pixels
+    // Uso do alpha pela imagem (não pela página inteira, que tem o espaço vazio entre elas)
+    AlphaMode alpha = AlphaMode::Translucent;
+};
+
+// Empacota várias imagens em uma ou mais páginas de textura (algoritmo de
+// prateleiras: imagens ordenadas pela altura e colocadas lado a lado em linhas)
+// Cada imagem ganha uma borda com a cópia dos seus pixels de canto, para que a
+// filtragem não misture vizinhos. As páginas têm largura pageSize e altura
+// cortada até a última prateleira ocupada
+// Imagens que precisam de GL_REPEAT (ex.: fundos com rolagem) não devem ir para o atlas
+class TextureAtlas
+{
+public:
+    // Carrega e empacota os arquivos; caminhos repetidos viram uma única região
+    // Retorna false se alguma imagem não pôde ser carregada ou não cabe na página
+    bool build(const std::vector<std::string> &filePaths, int pageSize = 4096, int padding = 2,
+               GLint filter = GL_NEAREST);
+
+    bool contains(const std::string &filePath) const;
+
+    // Região da imagem no atlas. Se ela não foi empacotada, a imagem é carregada
+    // como uma textura avulsa (e guardada para as próximas chamadas)
+    const TextureRegion &region(const std::string &filePath);
+
+    int pageCount() const { return (int)pages.size(); }
+
+    void release();
+
+private:
+    std::vector<GLuint> pages;
+    std::unordered_map<std::string, TextureRegion> regions;
+};
@@ -0,0 +1,219 @@
+#include "texture_cache.h"
+#include "texture.h"
+#include "gl_state.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    // FNV-1a de 64 bits: suficiente para identificar arquivos iguais
+    uint64_t hashBytes(const std::vector<unsigned char> &bytes, GLint filter)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char byte : bytes)
+        {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+        // O mesmo conteúdo com filtros diferentes são texturas diferentes
+        hash ^= (uint64_t)filter;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+
+    std::string canonicalKey(const std::string &filePath, GLint filter)
+    {
+        std::error_code error;
+        std::filesystem::path path = std::filesystem::weakly_canonical(filePath, error);
+        return (error ? filePath : path.string()) + "#" + std::to_string(filter);
+    }
+}
+
+TextureCache::TextureCache(size_t budgetBytes) : budgetBytes(budgetBytes)
+{
+}
+
+GLuint TextureCache::acquire(const std::string &filePath, int &width, int &height, GLint filter)
+{
+    std::string key = canonicalKey(filePath, filter);
+
+    // 1) Mesmo caminho: não precisa nem ler o arquivo
+    auto byPathIt = byPath.find(key);
+    if (byPathIt != byPath.end())
+    {
+        Entry &entry = entries[byPathIt->second];
+        entry.refCount++;
+        entry.lastUse = ++useCounter;
+        width = entry.width;
+        height = entry.height;
+        return entry.texID;
+    }
+
+    std::ifstream file(filePath, std::ios::binary);
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.empty())
+    {
+        std::cout << "Failed to load texture " << filePath << std::endl;
+        width = height = 0;
+        return 0;
+    }
+
+    // 2) Caminho novo com conteúdo já conhecido
+    uint64_t hash = hashBytes(bytes, filter);
+    auto byHashIt = byHash.find(hash);
+    if (byHashIt != byHash.end())
+    {
+        byPath[key] = byHashIt->second;
+        Entry &entry = entries[byHashIt->second];
+        entry.refCount++;
+        entry.lastUse = ++useCounter;
+        width = entry.width;
+        height = entry.height;
+        return entry.texID;
+    }
+
+    // 3) Conteúdo novo: decodifica a partir dos bytes já lidos
+    int nrChannels;
+    GLuint texID = loadTextureFromMemory(bytes.data(), bytes.size(), width, height, nrChannels, filter);
+    if (width == 0 || height == 0)
+    {
+        // Arquivo corrompido ou formato não suportado: não fica no cache como textura válida
+        glstate::forgetTexture(texID);
+        glDeleteTextures(1, &texID);
+        width = height = 0;
+        return 0;
+    }
+
+    Entry entry;
+    entry.texID = texID;
+    entry.width = width;
+    entry.height = height;
+    // RGB costuma ser armazenado com 4 bytes por pixel; os mipmaps somam ~1/3
+    entry.bytes = (size_t)width * height * 4 * 4 / 3;
+    entry.refCount = 1;
+    entry.lastUse = ++useCounter;
+    entry.hash = hash;
+
+    entries[texID] = entry;
+    byPath[key] = texID;
+    byHash[hash] = texID;
+    resident += entry.bytes;
+
+    enforceBudget();
+
+    return texID;
+}
+
+GLuint TextureCache::acquire(const std::string &filePath, GLint filter)
+{
+    int width, height;
+    return acquire(filePath, width, height, filter);
+}
+
+void TextureCache::release(GLuint texID)
+{
+    auto it = entries.find(texID);
+    if (it == entries.end() || it->second.refCount == 0)
+    {
+        return;
+    }
+
+    it->second.refCount--;
+    if (it->second.refCount == 0)
+    {
+        enforceBudget();
+    }
+}
+
+size_t TextureCache::collect()
+{
+    std::vector<GLuint> unused;
+    for (auto &entry : entries)
+    {
+        if (entry.second.refCount == 0)
+        {
+            unused.push_back(entry.first);
+        }
+    }
+
+    size_t before = resident;
+    for (GLuint texID : unused)
+    {
+        evict(texID);
+    }
+    return before - resident;
+}
+
+void TextureCache::clear()
+{
+    for (auto &entry : entries)
+    {
+        glstate::forgetTexture(entry.first);
+        glDeleteTextures(1, &entry.second.texID);
+    }
+    entries.clear();
+    byPath.clear();
+    byHash.clear();
+    resident = 0;
+}
+
+void TextureCache::setBudget(size_t bytes)
+{
+    budgetBytes = bytes;
+    enforceBudget();
+}
+
+void TextureCache::evict(GLuint texID)
+{
+    auto it = entries.find(texID);
+    if (it == entries.end())
+    {
+        return;
+    }
+
+    // Remove os caminhos que apontam para esta textura
+    for (auto pathIt = byPath.begin(); pathIt != byPath.end();)
+    {
+        if (pathIt->second == texID)
+        {
+            pathIt = byPath.erase(pathIt);
+        }
+        else
+        {
+            ++pathIt;
+        }
+    }
+    byHash.erase(it->second.hash);
+
+    resident -= it->second.bytes;
+    glstate::forgetTexture(texID);
+    glDeleteTextures(1, &texID);
+    entries.erase(it);
+}
+
+void TextureCache::enforceBudget()
+{
+    // Texturas referenciadas nunca saem: o orçamento pode ficar estourado
+    while (resident > budgetBytes)
+    {
+        GLuint victim = 0;
+        uint64_t oldest = UINT64_MAX;
+        for (auto &entry : entries)
+        {
+            if (entry.second.refCount == 0 && entry.second.lastUse < oldest)
+            {
+                oldest = entry.second.lastUse;
+                victim = entry.first;
+            }
+        }
+        if (!victim)
+        {
+            return;
+        }
+        evict(victim);
+    }
+}
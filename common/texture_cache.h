@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+// Cache de texturas com contagem de referências
+// Cada arquivo é identificado pelo caminho canônico e pelo hash do conteúdo:
+// o mesmo arquivo pedido duas vezes (ou por caminhos diferentes, ou duas cópias
+// idênticas em disco) vira uma única textura na GPU
+// Texturas sem referências continuam residentes até que o total passe do
+// orçamento de memória (as menos usadas recentemente saem primeiro) ou até um
+// collect()/clear() explícito
+class TextureCache
+{
+public:
+    explicit TextureCache(size_t budgetBytes = 256 * 1024 * 1024);
+
+    // Devolve a textura do arquivo e incrementa sua contagem de referências
+    GLuint acquire(const std::string &filePath, int &width, int &height, GLint filter = GL_NEAREST);
+    GLuint acquire(const std::string &filePath, GLint filter = GL_NEAREST);
+
+    // Decrementa a contagem; com zero referências a textura pode ser descartada
+    void release(GLuint texID);
+
+    // Descarta todas as texturas sem referências; retorna os bytes liberados
+    size_t collect();
+
+    // Descarta todas as texturas, referenciadas ou não (ex.: ao trocar de cena)
+    void clear();
+
+    size_t residentBytes() const { return resident; }
+    size_t budget() const { return budgetBytes; }
+    void setBudget(size_t bytes);
+
+private:
+    struct Entry
+    {
+        GLuint texID;
+        int width, height;
+        size_t bytes;      // estimativa com a cadeia de mipmaps
+        int refCount;
+        uint64_t lastUse;  // para escolher quem sai primeiro
+        uint64_t hash;
+    };
+
+    void evict(GLuint texID);
+    void enforceBudget();
+
+    size_t budgetBytes;
+    size_t resident = 0;
+    uint64_t useCounter = 0;
+
+    std::unordered_map<GLuint, Entry> entries;
+    std::unordered_map<std::string, GLuint> byPath; // caminho canônico + filtro
+    std::unordered_map<uint64_t, GLuint> byHash;    // hash do conteúdo + filtro
+};
@@ -0,0 +1,234 @@
+#include "texture_pack.h"
+#include "gl_state.h"
+#include "texture_alpha.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::string texpack::entryName(const std::string &filePath)
+{
+    std::string path = filePath;
+    for (char &c : path)
+    {
+        if (c == '\\')
+        {
+            c = '/';
+        }
+    }
+    size_t pos = path.rfind("assets/");
+    return pos == std::string::npos ? path : path.substr(pos + 7);
+}
+
+TexturePack::~TexturePack()
+{
+    close();
+}
+
+bool TexturePack::open(const std::string &filePath)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view)
+    {
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = (const unsigned char *)view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // o mapeamento continua válido sem o descritor
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+    data = (const unsigned char *)view;
+    size = (size_t)info.st_size;
+#endif
+
+    // Valida o cabeçalho e os limites de todas as entradas uma única vez
+    const texpack::PackHeader *header = (const texpack::PackHeader *)data;
+    bool valid = size >= sizeof(texpack::PackHeader) && memcmp(header->magic, texpack::MAGIC, 4) == 0 &&
+                 header->version == texpack::VERSION &&
+                 size >= sizeof(texpack::PackHeader) + (size_t)header->count * sizeof(texpack::PackEntry);
+
+    const texpack::PackEntry *entries = (const texpack::PackEntry *)(data + sizeof(texpack::PackHeader));
+    for (uint32_t i = 0; valid && i < header->count; i++)
+    {
+        const texpack::PackEntry &entry = entries[i];
+        valid = entry.format == texpack::FORMAT_RGBA8 && entry.levels >= 1 && entry.levels <= texpack::MAX_LEVELS &&
+                entry.alpha <= (uint32_t)AlphaMode::Translucent;
+        // Os valores vêm do arquivo: as contas são feitas de forma que não estourem
+        for (uint32_t level = 0; valid && level < entry.levels; level++)
+        {
+            uint64_t texels = (uint64_t)texpack::levelSize(entry.width, level) * texpack::levelSize(entry.height, level);
+            uint64_t offset = entry.levelOffsets[level];
+            valid = texels <= size / 4 && offset <= size && texels * 4 <= size - offset;
+        }
+    }
+
+    if (!valid)
+    {
+        std::cout << "Invalid texture pack " << filePath << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TexturePack::close()
+{
+    if (!data)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mappingHandle);
+    CloseHandle((HANDLE)fileHandle);
+    mappingHandle = fileHandle = nullptr;
+#else
+    munmap((void *)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+const texpack::PackEntry *TexturePack::find(const std::string &filePath) const
+{
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    std::string name = texpack::entryName(filePath);
+    const texpack::PackHeader *header = (const texpack::PackHeader *)data;
+    const texpack::PackEntry *entries = (const texpack::PackEntry *)(data + sizeof(texpack::PackHeader));
+
+    // As entradas são gravadas em ordem de nome: busca binária
+    uint32_t lo = 0, hi = header->count;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        int cmp = strncmp(entries[mid].name, name.c_str(), texpack::NAME_SIZE);
+        if (cmp == 0)
+        {
+            return &entries[mid];
+        }
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return nullptr;
+}
+
+bool TexturePack::contains(const std::string &filePath) const
+{
+    return find(filePath) != nullptr;
+}
+
+GLuint TexturePack::loadTexture(const std::string &filePath, int &width, int &height, GLint filter) const
+{
+    const texpack::PackEntry *entry = find(filePath);
+    if (!entry)
+    {
+        std::cout << "Texture " << filePath << " not found in the pack" << std::endl;
+        width = height = 0;
+        return 0;
+    }
+
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glstate::bindTexture(GL_TEXTURE_2D, texID);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, entry->levels - 1);
+
+    // Os mipmaps já vêm prontos no arquivo: cada nível é enviado direto da memória mapeada
+    for (uint32_t level = 0; level < entry->levels; level++)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, texpack::levelSize(entry->width, level),
+                     texpack::levelSize(entry->height, level), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     data + entry->levelOffsets[level]);
+    }
+    // Classificado uma vez pelo cooker: os pixels mapeados não são percorridos aqui
+    setTextureAlpha(texID, (AlphaMode)entry->alpha);
+
+    glstate::bindTexture(GL_TEXTURE_2D, 0);
+
+    width = entry->width;
+    height = entry->height;
+    return texID;
+}
+
+GLuint TexturePack::loadTexture(const std::string &filePath, GLint filter) const
+{
+    int width, height;
+    return loadTexture(filePath, width, height, filter);
+}
+
+uint32_t TexturePack::levels(const std::string &filePath) const
+{
+    const texpack::PackEntry *entry = find(filePath);
+    return entry ? entry->levels : 0;
+}
+
+const unsigned char *TexturePack::pixels(const std::string &filePath, uint32_t level, int &width, int &height) const
+{
+    const texpack::PackEntry *entry = find(filePath);
+    if (!entry || level >= entry->levels)
+    {
+        width = height = 0;
+        return nullptr;
+    }
+    width = texpack::levelSize(entry->width, level);
+    height = texpack::levelSize(entry->height, level);
+    return data + entry->levelOffsets[level];
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <glad/glad.h>
+
+// Formato do pacote de texturas gerado pelo texture_cooker (tools/)
+// [PackHeader][PackEntry x count][dados]
+// Os dados de cada entrada são RGBA8 já com a cadeia de mipmaps completa, nível 0
+// primeiro e os seguintes logo depois (cada nível alinhado em 16 bytes)
+namespace texpack
+{
+    const char MAGIC[4] = {'T', 'P', 'K', '1'};
+    const uint32_t VERSION = 2;
+    const uint32_t FORMAT_RGBA8 = 0;
+    const size_t NAME_SIZE = 112;
+    const int MAX_LEVELS = 16;
+
+    struct PackHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;    // número de entradas
+        uint32_t reserved;
+    };
+
+    struct PackEntry
+    {
+        char name[NAME_SIZE]; // caminho relativo à pasta assets/ (ex.: "sprites/sky.png")
+        uint32_t width, height;
+        uint32_t format;
+        uint32_t levels;
+        uint32_t alpha;    // AlphaMode do nível 0, classificado pelo cooker
+        uint32_t reserved;
+        uint64_t levelOffsets[MAX_LEVELS]; // a partir do início do arquivo
+    };
+
+    // Tamanho do nível (w, h) >> level, nunca menor que 1
+    inline uint32_t levelSize(uint32_t size, uint32_t level)
+    {
+        uint32_t s = size >> level;
+        return s ? s : 1;
+    }
+
+    // Nome da entrada para um caminho de asset: o trecho depois de "assets/"
+    std::string entryName(const std::string &filePath);
+}
+
+// Pacote aberto com mapeamento em memória: as texturas são enviadas para a GPU
+// direto do arquivo mapeado, sem decodificar PNG/JPEG e sem glGenerateMipmap
+class TexturePack
+{
+public:
+    TexturePack() = default;
+    ~TexturePack();
+
+    TexturePack(const TexturePack &) = delete;
+    TexturePack &operator=(const TexturePack &) = delete;
+
+    // Retorna false se o arquivo não existe ou não é um pacote válido
+    bool open(const std::string &filePath);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    // Aceita o mesmo caminho passado ao loadTexture (ex.: "../assets/sprites/sky.png")
+    bool contains(const std::string &filePath) const;
+
+    GLuint loadTexture(const std::string &filePath, int &width, int &height, GLint filter = GL_NEAREST) const;
+    GLuint loadTexture(const std::string &filePath, GLint filter = GL_NEAREST) const;
+
+    // Acesso direto aos pixels RGBA8 mapeados, para quem monta a própria textura
+    // (ex.: camadas de um array). levels() é 0 se a imagem não está no pacote
+    uint32_t levels(const std::string &filePath) const;
+    const unsigned char *pixels(const std::string &filePath, uint32_t level, int &width, int &height) const;
+
+private:
+    const texpack::PackEntry *find(const std::string &filePath) const;
+
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+};
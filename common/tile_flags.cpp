@@ -0,0 +1,37 @@
+#include "tile_flags.h"
+
+static_assert(mapfile::TILE_COLLECTIBLE <= 0xFF, "os atributos da célula precisam caber em TileFlags");
+
+void TileFlagsGrid::init(const MapFile &map, const uint16_t *cells)
+{
+    for (int tile = 0; tile < (int)mapfile::MAX_TILE_TYPES; tile++)
+    {
+        types[tile] = map.tileFlags(tile);
+    }
+
+    mapWidth = map.width();
+    mapHeight = map.height();
+    this->cells.assign((size_t)mapWidth * mapHeight, 0);
+    if (!cells)
+    {
+        return;
+    }
+    for (size_t n = 0; n < this->cells.size(); n++)
+    {
+        this->cells[n] = cellFlags(cells[n]);
+    }
+}
+
+void TileFlagsGrid::setTile(int i, int j, int tile)
+{
+    if (inside(i, j))
+    {
+        cells[(size_t)i * mapWidth + j] = cellFlags(tile);
+    }
+}
+
+// Célula vazia não tem chão: não pode ser pisada
+TileFlags TileFlagsGrid::cellFlags(int tile) const
+{
+    return tile == mapfile::EMPTY_CELL ? (TileFlags)mapfile::TILE_SOLID : (TileFlags)typeFlags(tile);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "map_file.h"
+
+// Atributos de uma célula: os bits TILE_* de mapfile (todos cabem em um byte)
+typedef uint8_t TileFlags;
+
+// Tabela de atributos por tipo de tile (uma palavra por tipo) e, ao lado do mapa,
+// uma camada já calculada com os atributos de cada célula. Consultas de colisão e
+// de gatilhos viram uma leitura e uma máscara, sem procurar o tile em listas; a
+// camada usa um byte por célula para que varreduras longas (IA, pathfinding) caibam
+// no cache
+// Células fora do mapa e células vazias são TILE_SOLID
+class TileFlagsGrid
+{
+public:
+    // Monta a tabela com os atributos do mapa e a camada a partir das células
+    // (width * height índices no tileset, linha a linha)
+    void init(const MapFile &map, const uint16_t *cells);
+
+    // Troca o tile da célula, atualizando os atributos dela
+    void setTile(int i, int j, int tile);
+
+    TileFlags flags(int i, int j) const
+    {
+        return inside(i, j) ? cells[(size_t)i * mapWidth + j] : (TileFlags)mapfile::TILE_SOLID;
+    }
+    bool test(int i, int j, uint32_t mask) const { return (flags(i, j) & mask) != 0; }
+    bool walkable(int i, int j) const { return !test(i, j, mapfile::TILE_SOLID); }
+
+    // Atributos do tipo de tile (0 para tipos desconhecidos)
+    uint32_t typeFlags(int tile) const
+    {
+        return tile >= 0 && tile < (int)mapfile::MAX_TILE_TYPES ? types[tile] : 0;
+    }
+
+    int width() const { return mapWidth; }
+    int height() const { return mapHeight; }
+    // Camada inteira (width * height bytes, linha a linha)
+    const TileFlags *data() const { return cells.data(); }
+
+private:
+    bool inside(int i, int j) const { return (unsigned)i < (unsigned)mapHeight && (unsigned)j < (unsigned)mapWidth; }
+    TileFlags cellFlags(int tile) const;
+
+    std::array<uint32_t, mapfile::MAX_TILE_TYPES> types{};
+    std::vector<TileFlags> cells;
+    int mapWidth = 0, mapHeight = 0;
+};
@@ -0,0 +1,393 @@
+#include "tilemap.h"
+#include "gl_state.h"
+#include "texture_alpha.h"
+
+#include <algorithm>
+#include <cmath>
+
+ArrayChunkSource::ArrayChunkSource(const int *cells, int width, int height)
+    : cells(cells), width(width), height(height)
+{
+}
+
+void ArrayChunkSource::load(int ci, int cj, uint16_t *tiles)
+{
+    for (int di = 0; di < CHUNK_SIZE; di++)
+    {
+        for (int dj = 0; dj < CHUNK_SIZE; dj++)
+        {
+            int i = ci * CHUNK_SIZE + di, j = cj * CHUNK_SIZE + dj;
+            bool inside = i >= 0 && i < height && j >= 0 && j < width;
+            tiles[di * CHUNK_SIZE + dj] = inside ? (uint16_t)cells[i * width + j] : EMPTY_TILE;
+        }
+    }
+}
+
+LayerChunkSource::LayerChunkSource(const uint16_t *cells, int width, int height)
+    : cells(cells), width(width), height(height)
+{
+}
+
+void LayerChunkSource::load(int ci, int cj, uint16_t *tiles)
+{
+    std::fill(tiles, tiles + CHUNK_SIZE * CHUNK_SIZE, EMPTY_TILE);
+
+    int j0 = cj * CHUNK_SIZE;
+    int columns = std::min(CHUNK_SIZE, width - j0);
+    if (!cells || j0 < 0 || columns <= 0)
+    {
+        return;
+    }
+
+    // As linhas do mapa são contíguas: uma cópia por linha do chunk
+    for (int di = 0; di < CHUNK_SIZE; di++)
+    {
+        int i = ci * CHUNK_SIZE + di;
+        if (i >= 0 && i < height)
+        {
+            std::copy(cells + (size_t)i * width + j0, cells + (size_t)i * width + j0 + columns, tiles + di * CHUNK_SIZE);
+        }
+    }
+}
+
+FileChunkSource::FileChunkSource(const std::string &filePath, int width, int height, std::streamoff offset)
+    : file(filePath, std::ios::binary), width(width), height(height), offset(offset)
+{
+}
+
+void FileChunkSource::load(int ci, int cj, uint16_t *tiles)
+{
+    std::fill(tiles, tiles + CHUNK_SIZE * CHUNK_SIZE, EMPTY_TILE);
+
+    int j0 = cj * CHUNK_SIZE;
+    int columns = std::min(CHUNK_SIZE, width - j0);
+    if (!file.is_open() || j0 < 0 || columns <= 0)
+    {
+        return;
+    }
+
+    // Uma leitura por linha do chunk: as linhas do mapa são contíguas no arquivo
+    for (int di = 0; di < CHUNK_SIZE; di++)
+    {
+        int i = ci * CHUNK_SIZE + di;
+        if (i < 0 || i >= height)
+        {
+            continue;
+        }
+        file.clear();
+        file.seekg(offset + ((std::streamoff)i * width + j0) * (std::streamoff)sizeof(uint16_t));
+        file.read((char *)(tiles + di * CHUNK_SIZE), columns * sizeof(uint16_t));
+    }
+}
+
+void ChunkedTilemap::init(ChunkSource *source, int width, int height, GLuint tilesetTexID, int nTiles,
+                          const glm::vec2 &tileDimensions, const glm::vec2 &origin, int maxResidentChunks)
+{
+    this->source = source;
+    this->mapWidth = width;
+    this->mapHeight = height;
+    this->texID = tilesetTexID;
+    this->tileDimensions = tileDimensions;
+    this->origin = origin;
+    this->maxResident = std::max(maxResidentChunks, 1);
+
+    shader = ShaderProgram::fromFiles("tilemap.vert", "textured_cutout.frag");
+    projectionLoc = shader.uniform("projection");
+    chunkOriginLoc = shader.uniform("chunkOrigin");
+    alphaCutoffLoc = shader.uniform("alphaCutoff");
+
+    // Uniforms constantes do mapa: enviados uma única vez
+    shader.use();
+    shader.setInt(shader.uniform("tex_buff"), 0);
+    shader.setVec2(shader.uniform("origin"), origin);
+    shader.setVec2(shader.uniform("tileDimensions"), tileDimensions);
+    shader.setFloat(shader.uniform("ds"), 1.0f / (float)nTiles);
+    shader.setInt(shader.uniform("chunkSize"), CHUNK_SIZE);
+
+    // Mesmo losango 2:1 de setupTile, compartilhado por todos os chunks
+    float ds = 1.0f / (float)nTiles, dt = 1.0f;
+    GLfloat vertices[] = {
+        // x   y    z    s     t
+        0.0f, 0.5f, 0.0f, 0.0f, dt / 2.0f, // A
+        0.5f, 1.0f, 0.0f, ds / 2.0f, dt,   // B
+        0.5f, 0.0f, 0.0f, ds / 2.0f, 0.0f, // D
+        1.0f, 0.5f, 0.0f, ds, dt / 2.0f    // C
+    };
+    glGenBuffers(1, &quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ChunkedTilemap::setProjection(const glm::mat4 &projection)
+{
+    shader.use();
+    shader.setMat4(projectionLoc, projection);
+}
+
+ChunkedTilemap::Chunk *ChunkedTilemap::find(int ci, int cj)
+{
+    auto it = chunks.find(key(ci, cj));
+    return it == chunks.end() ? nullptr : &it->second;
+}
+
+ChunkedTilemap::Chunk &ChunkedTilemap::load(int ci, int cj)
+{
+    Chunk &chunk = chunks[key(ci, cj)];
+    chunk.ci = ci;
+    chunk.cj = cj;
+    chunk.tiles.resize(CHUNK_SIZE * CHUNK_SIZE);
+    source->load(ci, cj, chunk.tiles.data());
+
+    // As instâncias vão até a última célula do mapa dentro do chunk; nos chunks da
+    // borda direita as células além da última coluna ficam vazias
+    int rows = std::min(CHUNK_SIZE, mapHeight - ci * CHUNK_SIZE);
+    int columns = std::min(CHUNK_SIZE, mapWidth - cj * CHUNK_SIZE);
+    chunk.instanceCount = (rows - 1) * CHUNK_SIZE + columns;
+    chunk.dirtyFirst = 0;
+    chunk.dirtyLast = chunk.instanceCount - 1;
+    chunk.lastUsed = frame;
+    return chunk;
+}
+
+int ChunkedTilemap::tile(int i, int j)
+{
+    if (i < 0 || i >= mapHeight || j < 0 || j >= mapWidth)
+    {
+        return EMPTY_TILE;
+    }
+    int ci = i / CHUNK_SIZE, cj = j / CHUNK_SIZE;
+    Chunk *chunk = find(ci, cj);
+    if (!chunk)
+    {
+        chunk = &load(ci, cj);
+    }
+    return chunk->tiles[(i % CHUNK_SIZE) * CHUNK_SIZE + j % CHUNK_SIZE];
+}
+
+void ChunkedTilemap::setTile(int i, int j, int value)
+{
+    if (i < 0 || i >= mapHeight || j < 0 || j >= mapWidth)
+    {
+        return;
+    }
+    int ci = i / CHUNK_SIZE, cj = j / CHUNK_SIZE;
+    Chunk *chunk = find(ci, cj);
+    if (!chunk)
+    {
+        chunk = &load(ci, cj);
+    }
+
+    int index = (i % CHUNK_SIZE) * CHUNK_SIZE + j % CHUNK_SIZE;
+    if (chunk->tiles[index] != (uint16_t)value)
+    {
+        chunk->tiles[index] = (uint16_t)value;
+        chunk->dirtyFirst = std::min(chunk->dirtyFirst, index);
+        chunk->dirtyLast = std::max(chunk->dirtyLast, index);
+        chunk->edited = true;
+    }
+}
+
+// Envia para a GPU o trecho de células alteradas desde o último upload. O buffer tem
+// o mesmo layout de chunk.tiles, então o trecho é uma cópia direta com glBufferSubData;
+// células alteradas longe umas das outras são enviadas em um único trecho que cobre
+// todas (no pior caso o chunk inteiro, 2 KB)
+void ChunkedTilemap::upload(Chunk &chunk)
+{
+    if (!chunk.VAO)
+    {
+        if (!freeBuffers.empty())
+        {
+            chunk.VAO = freeBuffers.back().first;
+            chunk.instanceVBO = freeBuffers.back().second;
+            freeBuffers.pop_back();
+        }
+        else
+        {
+            glGenBuffers(1, &chunk.instanceVBO);
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.instanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, CHUNK_SIZE * CHUNK_SIZE * sizeof(uint16_t), NULL, GL_DYNAMIC_DRAW);
+
+            glGenVertexArrays(1, &chunk.VAO);
+            glstate::bindVertexArray(chunk.VAO);
+
+            // Atributos 0 e 1 - Geometria do losango, compartilhada
+            glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+            glEnableVertexAttribArray(1);
+
+            // Atributo 2 - Índice no tileset, inteiro (avança uma vez por tile, não por vértice)
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.instanceVBO);
+            glVertexAttribIPointer(2, 1, GL_UNSIGNED_SHORT, sizeof(uint16_t), (GLvoid *)0);
+            glEnableVertexAttribArray(2);
+            glVertexAttribDivisor(2, 1);
+
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glstate::bindVertexArray(0);
+        }
+    }
+
+    GLintptr offset = chunk.dirtyFirst * sizeof(uint16_t);
+    GLsizeiptr size = (chunk.dirtyLast - chunk.dirtyFirst + 1) * sizeof(uint16_t);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, offset, size, chunk.tiles.data() + chunk.dirtyFirst);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    lastUploaded += (int)size;
+
+    chunk.dirtyFirst = CHUNK_SIZE * CHUNK_SIZE;
+    chunk.dirtyLast = -1;
+}
+
+void ChunkedTilemap::draw(const glm::vec4 &view)
+{
+    frame++;
+    lastDrawn = 0;
+    lastUploaded = 0;
+    if (!source || mapWidth <= 0 || mapHeight <= 0)
+    {
+        return;
+    }
+
+    float w = tileDimensions.x, h = tileDimensions.y;
+
+    // Faixas de j - i e j + i dos tiles que intersectam a região visível (o tile ocupa
+    // [x, x + w] x [y, y + h]), levadas de volta para linhas e colunas. O losango
+    // resultante é coberto por um retângulo de chunks, testados um a um abaixo
+    float uMin = 2.0f * (view.x - origin.x) / w - 2.0f, uMax = 2.0f * (view.y - origin.x) / w;
+    float vMin = 2.0f * (view.z - origin.y) / h - 2.0f, vMax = 2.0f * (view.w - origin.y) / h;
+
+    int iMin = std::max((int)std::floor((vMin - uMax) / 2.0f), 0);
+    int iMax = std::min((int)std::ceil((vMax - uMin) / 2.0f), mapHeight - 1);
+    int jMin = std::max((int)std::floor((uMin + vMin) / 2.0f), 0);
+    int jMax = std::min((int)std::ceil((uMax + vMax) / 2.0f), mapWidth - 1);
+    if (iMin > iMax || jMin > jMax)
+    {
+        return;
+    }
+
+    shader.use();
+    glstate::activeTexture(GL_TEXTURE0);
+    glstate::bindTexture(GL_TEXTURE_2D, texID);
+
+    // Estado de acordo com o alpha do tileset (consultado a cada draw: com o
+    // AsyncTextureLoader a classificação só chega junto com a imagem). Opaco ou
+    // recorte: sem blending e escrevendo profundidade, com o fundo transparente do
+    // losango descartado; translúcido: com blending e sem escrever profundidade
+    AlphaMode mode = textureAlpha(texID);
+    bool translucent = mode == AlphaMode::Translucent;
+    shader.setFloat(alphaCutoffLoc, mode == AlphaMode::Cutout ? 0.5f : 0.0f);
+    if (translucent)
+    {
+        glstate::enable(GL_BLEND);
+        glstate::depthMask(GL_FALSE);
+    }
+    else
+    {
+        glstate::disable(GL_BLEND);
+    }
+
+    int loads = 0;
+    for (int ci = iMin / CHUNK_SIZE; ci <= iMax / CHUNK_SIZE; ci++)
+    {
+        for (int cj = jMin / CHUNK_SIZE; cj <= jMax / CHUNK_SIZE; cj++)
+        {
+            // Retângulo do chunk na tela
+            int i0 = ci * CHUNK_SIZE, i1 = std::min(i0 + CHUNK_SIZE, mapHeight) - 1;
+            int j0 = cj * CHUNK_SIZE, j1 = std::min(j0 + CHUNK_SIZE, mapWidth) - 1;
+            float xMin = origin.x + (j0 - i1) * w / 2.0f, xMax = origin.x + (j1 - i0) * w / 2.0f + w;
+            float yMin = origin.y + (i0 + j0) * h / 2.0f, yMax = origin.y + (i1 + j1) * h / 2.0f + h;
+            if (xMax < view.x || xMin > view.y || yMax < view.z || yMin > view.w)
+            {
+                continue;
+            }
+
+            Chunk *chunk = find(ci, cj);
+            if (!chunk)
+            {
+                // Limite de leituras por frame: o chunk aparece nos próximos frames
+                if (loads >= maxLoadsPerFrame)
+                {
+                    continue;
+                }
+                chunk = &load(ci, cj);
+                loads++;
+            }
+            chunk->lastUsed = frame;
+
+            // Em um frame sem alterações nada é enviado: só os buffers já prontos são desenhados
+            if (chunk->dirty())
+            {
+                upload(*chunk);
+            }
+
+            shader.setVec2(chunkOriginLoc, glm::vec2(ci * CHUNK_SIZE, cj * CHUNK_SIZE));
+            glstate::bindVertexArray(chunk->VAO);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, chunk->instanceCount);
+            lastDrawn++;
+        }
+    }
+
+    if (translucent)
+    {
+        glstate::depthMask(GL_TRUE);
+    }
+    evict();
+}
+
+// Descarta os chunks menos usados recentemente enquanto houver mais que maxResident
+void ChunkedTilemap::evict()
+{
+    if ((int)chunks.size() <= maxResident)
+    {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> candidates; // (lastUsed, chave)
+    for (const auto &entry : chunks)
+    {
+        const Chunk &chunk = entry.second;
+        if (!chunk.edited && chunk.lastUsed != frame)
+        {
+            candidates.push_back({chunk.lastUsed, entry.first});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (size_t n = 0; n < candidates.size() && (int)chunks.size() > maxResident; n++)
+    {
+        auto it = chunks.find(candidates[n].second);
+        if (it->second.VAO)
+        {
+            freeBuffers.push_back({it->second.VAO, it->second.instanceVBO});
+        }
+        chunks.erase(it);
+    }
+}
+
+void ChunkedTilemap::release()
+{
+    for (auto &entry : chunks)
+    {
+        if (entry.second.VAO)
+        {
+            freeBuffers.push_back({entry.second.VAO, entry.second.instanceVBO});
+        }
+    }
+    chunks.clear();
+
+    for (const auto &buffers : freeBuffers)
+    {
+        glstate::forgetVertexArray(buffers.first);
+        glDeleteVertexArrays(1, &buffers.first);
+        glDeleteBuffers(1, &buffers.second);
+    }
+    freeBuffers.clear();
+
+    if (quadVBO)
+    {
+        glDeleteBuffers(1, &quadVBO);
+        quadVBO = 0;
+    }
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include "shader.h"
+
+// Lado de um chunk do tilemap, em tiles
+const int CHUNK_SIZE = 32;
+
+// Célula sem tile (fora do mapa ou vazia): não é desenhada
+const uint16_t EMPTY_TILE = 0xFFFF;
+
+// Origem dos dados do mapa, lida um chunk por vez conforme a câmera se move
+class ChunkSource
+{
+public:
+    virtual ~ChunkSource() = default;
+
+    // Preenche tiles (CHUNK_SIZE * CHUNK_SIZE, linha a linha) com o chunk da linha
+    // de chunks ci e coluna de chunks cj; células fora do mapa recebem EMPTY_TILE
+    virtual void load(int ci, int cj, uint16_t *tiles) = 0;
+};
+
+// Mapa em um array de int já em memória (linha a linha), como o map[][] dos exercícios
+class ArrayChunkSource : public ChunkSource
+{
+public:
+    ArrayChunkSource(const int *cells, int width, int height);
+    void load(int ci, int cj, uint16_t *tiles) override;
+
+private:
+    const int *cells;
+    int width, height;
+};
+
+// Camada de um mapa já em memória com células uint16 (linha a linha), como as do
+// MapFile mapeado: os chunks são copiados direto do arquivo, sem conversão
+class LayerChunkSource : public ChunkSource
+{
+public:
+    LayerChunkSource(const uint16_t *cells, int width, int height);
+    void load(int ci, int cj, uint16_t *tiles) override;
+
+private:
+    const uint16_t *cells;
+    int width, height;
+};
+
+// Mapa bruto em disco: width * height valores uint16 little-endian, linha a linha, a
+// partir de offset bytes. Cada chunk custa CHUNK_SIZE leituras curtas, então mapas de
+// 4096x4096 tiles nunca precisam estar inteiros na memória
+class FileChunkSource : public ChunkSource
+{
+public:
+    FileChunkSource(const std::string &filePath, int width, int height, std::streamoff offset = 0);
+    bool isOpen() const { return file.is_open(); }
+    void load(int ci, int cj, uint16_t *tiles) override;
+
+private:
+    std::ifstream file;
+    int width, height;
+    std::streamoff offset;
+};
+
+// Tilemap isométrico dividido em chunks de CHUNK_SIZE x CHUNK_SIZE tiles, cada um com
+// o seu buffer de instâncias e um único glDrawArraysInstanced
+// O buffer de um chunk guarda só o índice no tileset de cada célula (2 bytes), no
+// mesmo layout da cópia em memória: a linha e a coluna vêm de gl_InstanceID. Alterar
+// um tile marca só aquela célula como suja, e no próximo draw() apenas o trecho sujo
+// é reenviado com glBufferSubData; frames sem alteração não enviam nada
+// A cada draw(), só os chunks cujo retângulo na tela intersecta a região visível são
+// desenhados (mesma conta isométrica do desenharMapa: x = x0 + (j - i) * w / 2,
+// y = y0 + (j + i) * h / 2). Chunks ainda não residentes são lidos da ChunkSource, no
+// máximo maxLoadsPerFrame por frame, e os menos usados recentemente são descartados
+// quando passam de maxResidentChunks. Assim o custo por frame depende do tamanho da
+// tela, não do tamanho do mapa
+// Chunks alterados com setTile() nunca são descartados, para não perder a alteração
+// O tileset é tratado pelo seu AlphaMode (texture_alpha.h): opaco ou recorte é
+// desenhado sem blending e escrevendo profundidade (em z = 0), então fica atrás dos
+// sprites de um SpriteBatch com ordenação por profundidade desenhados antes
+class ChunkedTilemap
+{
+public:
+    ChunkedTilemap() = default;
+    ChunkedTilemap(const ChunkedTilemap &) = delete;
+    ChunkedTilemap &operator=(const ChunkedTilemap &) = delete;
+
+    // width e height em tiles; nTiles é o número de colunas do tileset; origin é a
+    // posição na tela do tile (0, 0) e tileDimensions o tamanho do losango 2:1
+    void init(ChunkSource *source, int width, int height, GLuint tilesetTexID, int nTiles,
+              const glm::vec2 &tileDimensions, const glm::vec2 &origin, int maxResidentChunks = 256);
+    void setProjection(const glm::mat4 &projection);
+
+    // Tile da célula (linha i, coluna j), carregando o chunk se preciso
+    int tile(int i, int j);
+    void setTile(int i, int j, int value);
+
+    // Desenha os chunks visíveis. view é a região visível em coordenadas de mundo:
+    // esquerda, direita, baixo e cima
+    void draw(const glm::vec4 &view);
+
+    int width() const { return mapWidth; }
+    int height() const { return mapHeight; }
+
+    // Estatísticas do último draw()
+    int drawnChunks() const { return lastDrawn; }
+    int uploadedBytes() const { return lastUploaded; }
+    int residentChunks() const { return (int)chunks.size(); }
+
+    // Programa do tilemap (shaders/tilemap.vert), ex.: para um ShaderWatcher
+    ShaderProgram &program() { return shader; }
+
+    // Libera todos os buffers (precisa do contexto OpenGL)
+    void release();
+
+    int maxLoadsPerFrame = 8;
+
+private:
+    struct Chunk
+    {
+        int ci, cj;
+        std::vector<uint16_t> tiles;
+        GLuint VAO = 0, instanceVBO = 0;
+        int instanceCount = 0;
+        // Trecho de células alteradas desde o último upload (vazio se first > last)
+        int dirtyFirst = 0, dirtyLast = -1;
+        bool edited = false; // alterado com setTile: fica residente
+        uint64_t lastUsed = 0;
+
+        bool dirty() const { return dirtyFirst <= dirtyLast; }
+    };
+
+    static uint64_t key(int ci, int cj) { return (uint64_t)(uint32_t)ci << 32 | (uint32_t)cj; }
+
+    Chunk *find(int ci, int cj);
+    Chunk &load(int ci, int cj);
+    void upload(Chunk &chunk);
+    void evict();
+
+    ShaderProgram shader;
+    int projectionLoc = -1;
+    int chunkOriginLoc = -1;
+    int alphaCutoffLoc = -1;
+    ChunkSource *source = nullptr;
+    int mapWidth = 0, mapHeight = 0;
+    glm::vec2 tileDimensions, origin;
+    GLuint texID = 0;
+    GLuint quadVBO = 0; // losango compartilhado por todos os chunks
+    int maxResident = 256;
+    uint64_t frame = 0;
+    int lastDrawn = 0;
+    int lastUploaded = 0;
+
+    std::unordered_map<uint64_t, Chunk> chunks;
+    // VAOs e VBOs de chunks descartados, reaproveitados pelos próximos
+    std::vector<std::pair<GLuint, GLuint>> freeBuffers;
+};
@@ -0,0 +1,124 @@
+#include "transform_kernel.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TRANSFORM_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TRANSFORM_SSE2 1
+#endif
+
+// Com u = metade do eixo x do sprite já girado e v = metade do eixo y:
+//   u = (w/2 * cos, w/2 * sin)   v = (-h/2 * sin, h/2 * cos)
+// os cantos são p - u + v, p - u - v, p + u + v e p + u - v
+void transform::quadCornersScalar(const float *x, const float *y, const float *width, const float *height,
+                                  const float *cosR, const float *sinR, size_t count, float *corners)
+{
+    for (size_t n = 0; n < count; n++)
+    {
+        float hw = 0.5f * width[n], hh = 0.5f * height[n];
+        float ux = hw * cosR[n], uy = hw * sinR[n];
+        float vx = -hh * sinR[n], vy = hh * cosR[n];
+        float *out = corners + n * 8;
+        out[0] = x[n] - ux + vx;
+        out[1] = y[n] - uy + vy;
+        out[2] = x[n] - ux - vx;
+        out[3] = y[n] - uy - vy;
+        out[4] = x[n] + ux + vx;
+        out[5] = y[n] + uy + vy;
+        out[6] = x[n] + ux - vx;
+        out[7] = y[n] + uy - vy;
+    }
+}
+
+#ifdef TRANSFORM_SSE2
+namespace
+{
+    // Recebe x e y de cada canto para 4 sprites (um sprite por elemento) e grava os
+    // 8 floats de cada sprite em sequência: intercala x com y e junta os cantos aos pares
+    inline void storeCorners(float *out, __m128 x0, __m128 y0, __m128 x1, __m128 y1, __m128 x2, __m128 y2,
+                             __m128 x3, __m128 y3)
+    {
+        __m128 lo01 = _mm_unpacklo_ps(x0, y0), hi01 = _mm_unpackhi_ps(x0, y0); // canto 0
+        __m128 lo11 = _mm_unpacklo_ps(x1, y1), hi11 = _mm_unpackhi_ps(x1, y1); // canto 1
+        __m128 lo21 = _mm_unpacklo_ps(x2, y2), hi21 = _mm_unpackhi_ps(x2, y2); // canto 2
+        __m128 lo31 = _mm_unpacklo_ps(x3, y3), hi31 = _mm_unpackhi_ps(x3, y3); // canto 3
+
+        _mm_storeu_ps(out + 0, _mm_movelh_ps(lo01, lo11));
+        _mm_storeu_ps(out + 4, _mm_movelh_ps(lo21, lo31));
+        _mm_storeu_ps(out + 8, _mm_movehl_ps(lo11, lo01));
+        _mm_storeu_ps(out + 12, _mm_movehl_ps(lo31, lo21));
+        _mm_storeu_ps(out + 16, _mm_movelh_ps(hi01, hi11));
+        _mm_storeu_ps(out + 20, _mm_movelh_ps(hi21, hi31));
+        _mm_storeu_ps(out + 24, _mm_movehl_ps(hi11, hi01));
+        _mm_storeu_ps(out + 28, _mm_movehl_ps(hi31, hi21));
+    }
+
+    inline void cornersSSE(__m128 px, __m128 py, __m128 w, __m128 h, __m128 c, __m128 s, float *out)
+    {
+        const __m128 half = _mm_set1_ps(0.5f);
+        __m128 hw = _mm_mul_ps(half, w), hh = _mm_mul_ps(half, h);
+        __m128 ux = _mm_mul_ps(hw, c), uy = _mm_mul_ps(hw, s);
+        __m128 vx = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(hh, s)), vy = _mm_mul_ps(hh, c);
+
+        __m128 ax = _mm_sub_ps(px, ux), ay = _mm_sub_ps(py, uy); // p - u
+        __m128 bx = _mm_add_ps(px, ux), by = _mm_add_ps(py, uy); // p + u
+        storeCorners(out, _mm_add_ps(ax, vx), _mm_add_ps(ay, vy), _mm_sub_ps(ax, vx), _mm_sub_ps(ay, vy),
+                     _mm_add_ps(bx, vx), _mm_add_ps(by, vy), _mm_sub_ps(bx, vx), _mm_sub_ps(by, vy));
+    }
+}
+#endif
+
+void transform::quadCorners(const float *x, const float *y, const float *width, const float *height,
+                            const float *cosR, const float *sinR, size_t count, float *corners)
+{
+    size_t n = 0;
+#if defined(TRANSFORM_AVX2)
+    // A conta é feita em 256 bits e cada metade é gravada com o entrelaçamento de
+    // 128 bits: os embaralhamentos de 256 bits não cruzam as metades
+    const __m256 half = _mm256_set1_ps(0.5f);
+    for (; n + 8 <= count; n += 8)
+    {
+        __m256 px = _mm256_loadu_ps(x + n), py = _mm256_loadu_ps(y + n);
+        __m256 hw = _mm256_mul_ps(half, _mm256_loadu_ps(width + n));
+        __m256 hh = _mm256_mul_ps(half, _mm256_loadu_ps(height + n));
+        __m256 c = _mm256_loadu_ps(cosR + n), s = _mm256_loadu_ps(sinR + n);
+        __m256 ux = _mm256_mul_ps(hw, c), uy = _mm256_mul_ps(hw, s);
+        __m256 vx = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(hh, s)), vy = _mm256_mul_ps(hh, c);
+
+        __m256 ax = _mm256_sub_ps(px, ux), ay = _mm256_sub_ps(py, uy);
+        __m256 bx = _mm256_add_ps(px, ux), by = _mm256_add_ps(py, uy);
+        __m256 k[8] = {_mm256_add_ps(ax, vx), _mm256_add_ps(ay, vy), _mm256_sub_ps(ax, vx), _mm256_sub_ps(ay, vy),
+                       _mm256_add_ps(bx, vx), _mm256_add_ps(by, vy), _mm256_sub_ps(bx, vx), _mm256_sub_ps(by, vy)};
+
+        float *out = corners + n * 8;
+        storeCorners(out, _mm256_castps256_ps128(k[0]), _mm256_castps256_ps128(k[1]), _mm256_castps256_ps128(k[2]),
+                     _mm256_castps256_ps128(k[3]), _mm256_castps256_ps128(k[4]), _mm256_castps256_ps128(k[5]),
+                     _mm256_castps256_ps128(k[6]), _mm256_castps256_ps128(k[7]));
+        storeCorners(out + 32, _mm256_extractf128_ps(k[0], 1), _mm256_extractf128_ps(k[1], 1),
+                     _mm256_extractf128_ps(k[2], 1), _mm256_extractf128_ps(k[3], 1), _mm256_extractf128_ps(k[4], 1),
+                     _mm256_extractf128_ps(k[5], 1), _mm256_extractf128_ps(k[6], 1), _mm256_extractf128_ps(k[7], 1));
+    }
+#endif
+#if defined(TRANSFORM_SSE2)
+    for (; n + 4 <= count; n += 4)
+    {
+        cornersSSE(_mm_loadu_ps(x + n), _mm_loadu_ps(y + n), _mm_loadu_ps(width + n), _mm_loadu_ps(height + n),
+                   _mm_loadu_ps(cosR + n), _mm_loadu_ps(sinR + n), corners + n * 8);
+    }
+#endif
+    // Sobra (menos que uma iteração vetorial) ou arquitetura sem SIMD
+    quadCornersScalar(x + n, y + n, width + n, height + n, cosR + n, sinR + n, count - n, corners + n * 8);
+}
+
+const char *transform::backend()
+{
+#if defined(TRANSFORM_AVX2)
+    return "AVX2";
+#elif defined(TRANSFORM_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+// Cálculo em lote dos cantos de sprites (quadrados com centro, tamanho e rotação),
+// sem montar uma mat4 por sprite com translate/rotate/scale
+// A entrada é uma estrutura de arrays (um vetor por campo) e a saída tem 8 floats
+// por sprite: x e y dos cantos V0 V1 V2 V3, na ordem de setupSprite
+//   V0 = (-0.5,  0.5)  V1 = (-0.5, -0.5)  V2 = (0.5, 0.5)  V3 = (0.5, -0.5)
+// Com AVX2 (opção ENGINE_AVX2 do CMake) são 8 sprites por iteração; com SSE2
+// (sempre disponível em x86-64) são 4; nas outras arquiteturas, o laço escalar
+namespace transform
+{
+    // cosR e sinR são o cosseno e o seno da rotação de cada sprite: quem chama pode
+    // evitar as funções trigonométricas nos sprites sem rotação (1 e 0)
+    void quadCorners(const float *x, const float *y, const float *width, const float *height, const float *cosR,
+                     const float *sinR, size_t count, float *corners);
+
+    // Mesma conta, sempre no laço escalar (referência para comparar com o vetorizado)
+    void quadCornersScalar(const float *x, const float *y, const float *width, const float *height,
+                           const float *cosR, const float *sinR, size_t count, float *corners);
+
+    // Conjunto de instruções usado por quadCorners: "AVX2", "SSE2" ou "scalar"
+    const char *backend();
+}
@@ -0,0 +1,115 @@
+#include "window.h"
+#include "gl_utils.h"
+
+#include <iostream>
+
+// Hints do contexto: OpenGL 4.1 core
+static void setContextHints()
+{
+    // Muita atenção aqui: alguns ambientes não aceitam essas configurações
+    // Você deve adaptar para a versão do OpenGL suportada por sua placa
+    // Sugestão: comente essas linhas de código para desobrir a versão e
+    // depois atualize (por exemplo: 4.5 com 4 e 5)
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+}
+
+// Janela invisível; se não houver servidor gráfico, usa a plataforma nula com OSMesa
+static GLFWwindow *createHeadlessWindow(int width, int height, const char *title)
+{
+    if (glfwInit())
+    {
+        setContextHints();
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow *window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (window)
+        {
+            return window;
+        }
+        glfwTerminate();
+    }
+
+    if (!glfwPlatformSupported(GLFW_PLATFORM_NULL))
+    {
+        return nullptr;
+    }
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (!glfwInit())
+    {
+        return nullptr;
+    }
+    setContextHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    GLFWwindow *window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+    if (!window)
+    {
+        glfwTerminate();
+    }
+    return window;
+}
+
+GLFWwindow *createWindow(int width, int height, const char *title, bool headless)
+{
+    GLFWwindow *window;
+    if (headless)
+    {
+        window = createHeadlessWindow(width, height, title);
+        if (!window)
+        {
+            std::cerr << "Falha ao criar o contexto headless" << std::endl;
+            return nullptr;
+        }
+    }
+    else
+    {
+        // Inicialização da GLFW
+        if (!glfwInit())
+        {
+            std::cerr << "Falha ao inicializar a GLFW" << std::endl;
+            return nullptr;
+        }
+
+        setContextHints();
+
+        // Ativa a suavização de serrilhado (MSAA) com 8 amostras por pixel
+        glfwWindowHint(GLFW_SAMPLES, 8);
+
+        // Criação da janela GLFW
+        window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+        if (!window)
+        {
+            std::cerr << "Falha ao criar a janela GLFW" << std::endl;
+            glfwTerminate();
+            return nullptr;
+        }
+    }
+    glfwMakeContextCurrent(window);
+
+    // GLAD: carrega todos os ponteiros d funções da OpenGL
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cerr << "Falha ao inicializar GLAD" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+
+    printGLInfo();
+
+    // Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
+    // (no modo headless, com as do FBO, que tem o tamanho pedido)
+    int fbWidth = width, fbHeight = height;
+    if (!headless)
+    {
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+    }
+    else
+    {
+        glfwSwapInterval(0); // sem vsync: os frames não devem esperar pela tela
+    }
+    glstate::viewport(0, 0, fbWidth, fbHeight);
+
+    return window;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+// Inicializa a GLFW, cria uma janela com contexto OpenGL 4.1 core (MSAA com 8
+// amostras), carrega os ponteiros de função da OpenGL via GLAD, exibe as
+// informações de versão e ajusta a viewport ao tamanho do framebuffer
+// Retorna nullptr (e já finaliza a GLFW) em caso de falha
+// Com headless, a janela fica invisível e sem MSAA (o desenho vai para um FBO,
+// veja benchmark.h); sem servidor gráfico, tenta a plataforma nula da GLFW com
+// um contexto OSMesa (ex.: Mesa llvmpipe em máquinas de CI)
+GLFWwindow *createWindow(int width, int height, const char *title, bool headless = false);
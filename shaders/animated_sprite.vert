@@ -0,0 +1,32 @@
+#version 400
+// Sprite animado por instância: o frame sai do tempo (ou vem fixo da CPU), sem uniform por desenho
+#include "projection.glsl"
+layout (location = 0) in vec2 corner;    // canto do quadrado unitário
+layout (location = 1) in vec3 position;  // centro do sprite
+layout (location = 2) in vec2 size;      // tamanho na tela
+layout (location = 3) in uint animation; // índice em clips, ou camada fixa com o bit alto
+layout (location = 4) in float startTime;
+out vec2 tex_coord;
+flat out float layer;
+uniform float time;
+// Mesmo tamanho de AnimatedSpriteRenderer::MAX_ANIMATIONS
+// Cada animação: primeira camada, número de frames, quadros por segundo, loop (1 ou 0)
+uniform vec4 clips[64];
+void main()
+{
+	if ((animation & 0x80000000u) != 0u)
+	{
+		// Frame escolhido na CPU (AnimatedSpriteRenderer::setLayer)
+		layer = float(animation & 0x7FFFFFFFu);
+	}
+	else
+	{
+		vec4 clip = clips[animation];
+		float frame = floor(max(time - startTime, 0.0) * clip.z);
+		frame = clip.w > 0.5 ? mod(frame, clip.y) : min(frame, clip.y - 1.0);
+		layer = clip.x + frame;
+	}
+	// A primeira linha da imagem fica em t = 0: o topo do quadrado lê t = 0
+	tex_coord = vec2(corner.x + 0.5, 0.5 - corner.y);
+	gl_Position = toClip(position + vec3(corner * size, 0.0));
+}
@@ -0,0 +1,8 @@
+#version 400
+// Retângulo cobrindo a tela inteira, direto em coordenadas de clip, gerado a partir
+// de gl_VertexID (GL_TRIANGLE_STRIP com 4 vértices, sem buffer de vértices)
+void main()
+{
+	vec2 corner = vec2(gl_VertexID >> 1, gl_VertexID & 1);
+	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
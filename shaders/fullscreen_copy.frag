@@ -0,0 +1,8 @@
+#version 400
+// Copia, pixel a pixel, uma textura do mesmo tamanho do framebuffer de destino
+uniform sampler2D image;
+out vec4 color;
+void main()
+{
+	color = texelFetch(image, ivec2(gl_FragCoord.xy), 0);
+}
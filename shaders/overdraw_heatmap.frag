@@ -0,0 +1,16 @@
+#version 400
+// Cor do mapa de calor dos pixels com count fragmentos (selecionados pelo stencil):
+// preto sem nenhum, de azul (1) a vermelho (maxCount ou mais)
+uniform int count;
+uniform int maxCount;
+out vec4 color;
+void main()
+{
+	if (count == 0)
+	{
+		color = vec4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+	float t = float(count - 1) / float(max(maxCount - 1, 1));
+	color = vec4(clamp(1.5 - abs(4.0 * t - vec3(3.0, 2.0, 1.0)), 0.0, 1.0), 1.0);
+}
@@ -0,0 +1,38 @@
+#version 400
+// Todas as camadas do parallax num único passe, da frente (última) para trás,
+// parando quando o pixel já está opaco. Fora do retângulo com alpha > 0 de uma
+// camada, ela nem é amostrada
+const int MAX_LAYERS = 16; // ParallaxRenderer::MAX_LAYERS
+in vec2 tex_coord;
+out vec4 color;
+uniform sampler2DArray layers;
+uniform int layerCount;
+uniform vec4 layerScroll[MAX_LAYERS]; // fator de velocidade, deslocamento próprio (pixels)
+uniform vec4 layerBounds[MAX_LAYERS]; // uMin, vMin, uMax, vMax
+uniform float scroll;
+uniform float viewWidth;
+void main()
+{
+	// Derivadas fora do laço: dentro de um if elas não são definidas, e o
+	// deslocamento de cada camada é constante, então valem para todas
+	vec2 dx = dFdx(tex_coord);
+	vec2 dy = dFdy(tex_coord);
+
+	vec4 sum = vec4(0.0); // alpha pré-multiplicado
+	for (int i = layerCount - 1; i >= 0 && sum.a < 0.996; i--)
+	{
+		float u = tex_coord.x + (scroll * layerScroll[i].x + layerScroll[i].y) / viewWidth;
+		vec2 wrapped = vec2(fract(u), tex_coord.y);
+		if (any(lessThan(wrapped, layerBounds[i].xy)) || any(greaterThan(wrapped, layerBounds[i].zw)))
+		{
+			continue;
+		}
+		vec4 texel = textureGrad(layers, vec3(u, tex_coord.y, float(i)), dx, dy);
+		sum += (1.0 - sum.a) * vec4(texel.rgb * texel.a, texel.a);
+	}
+	if (sum.a <= 0.0)
+	{
+		discard;
+	}
+	color = vec4(sum.rgb / sum.a, sum.a);
+}
@@ -0,0 +1,12 @@
+#version 400
+// Retângulo do fundo gerado a partir de gl_VertexID (sem buffer de vértices), na
+// ordem do GL_TRIANGLE_STRIP: (0,0), (0,1), (1,0), (1,1)
+#include "projection.glsl"
+uniform vec4 rect; // x, y, largura e altura na tela
+out vec2 tex_coord;
+void main()
+{
+	vec2 corner = vec2(gl_VertexID >> 1, gl_VertexID & 1);
+	tex_coord = corner;
+	gl_Position = toClip(vec3(rect.xy + corner * rect.zw, 0.0));
+}
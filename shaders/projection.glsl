@@ -0,0 +1,7 @@
+// Projeção ortográfica da cena, enviada pelo setProjection de cada desenhador
+uniform mat4 projection;
+
+vec4 toClip(vec3 position)
+{
+	return projection * vec4(position, 1.0);
+}
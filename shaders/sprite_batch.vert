@@ -0,0 +1,11 @@
+#version 400
+// Os vértices já chegam em coordenadas de mundo e com a coordenada de textura final
+#include "projection.glsl"
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+out vec2 tex_coord;
+void main()
+{
+	tex_coord = texc;
+	gl_Position = toClip(position);
+}
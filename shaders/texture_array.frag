@@ -0,0 +1,9 @@
+#version 400
+in vec2 tex_coord;
+flat in float layer;
+out vec4 color;
+uniform sampler2DArray tex_buff;
+void main()
+{
+	color = texture(tex_buff, vec3(tex_coord, layer));
+}
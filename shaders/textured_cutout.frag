@@ -0,0 +1,17 @@
+#version 400
+// Textura com recorte (AlphaMode::Cutout): texels com alpha abaixo de alphaCutoff são
+// descartados e o resto sai opaco, escrevendo profundidade como um sprite opaco
+// Com alphaCutoff = 0 nada é descartado
+in vec2 tex_coord;
+out vec4 color;
+uniform sampler2D tex_buff;
+uniform float alphaCutoff;
+void main()
+{
+	vec4 texel = texture(tex_buff, tex_coord);
+	if (texel.a < alphaCutoff)
+	{
+		discard;
+	}
+	color = alphaCutoff > 0.0 ? vec4(texel.rgb, 1.0) : texel;
+}
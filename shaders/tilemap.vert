@@ -0,0 +1,30 @@
+#version 400
+// Cada instância é uma célula do chunk e traz só o índice no tileset: a linha e a
+// coluna saem de gl_InstanceID e da origem do chunk, e a posição isométrica é
+// calculada aqui, sem matriz de modelo por tile
+#include "projection.glsl"
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+layout (location = 2) in uint iTile;
+out vec2 tex_coord;
+uniform vec2 origin;
+uniform vec2 tileDimensions;
+uniform float ds;
+uniform int chunkSize;
+uniform vec2 chunkOrigin; // linha e coluna da primeira célula do chunk
+void main()
+{
+	// Célula vazia: o losango fica fora do volume de recorte e não gera fragmentos
+	if (iTile == 0xFFFFu)
+	{
+		tex_coord = vec2(0.0);
+		gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+		return;
+	}
+	float i = chunkOrigin.x + float(gl_InstanceID / chunkSize);
+	float j = chunkOrigin.y + float(gl_InstanceID % chunkSize);
+	float x = origin.x + (j - i) * tileDimensions.x / 2.0;
+	float y = origin.y + (j + i) * tileDimensions.y / 2.0;
+	tex_coord = vec2(texc.s + float(iTile) * ds, 1.0 - texc.t);
+	gl_Position = toClip(vec3(position.xy * tileDimensions + vec2(x, y), position.z));
+}
@@ -2,6 +2,9 @@
 #include <string>
 #include <assert.h>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 using namespace std;
 
@@ -11,15 +14,14 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
-// STB_IMAGE
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 struct Sprite
@@ -35,13 +37,27 @@ struct Sprite
 
 Sprite principal;
 
+// O personagem é desenhado por instância junto com a multidão, mas o frame dele
+// vem de um animador na CPU: ele guarda o índice no renderer e o clip atual (id em
+// walkClips)
+AnimatedSpriteRenderer animated;
+int principalSprite = -1;
+int principalClip = 0;
+
+// Clips da spritesheet, lidos de Vampires1_Walk_full.anim (ids na biblioteca)
+AnimationLibrary walkClips;
+int walkDown, walkUp, walkLeft, walkRight;
+
+// Animador do personagem: escolhe o frame desenhado (AnimatedSpriteRenderer::setLayer)
+// e dispara os eventos "step" (pé no chão) nesse mesmo frame, contados no título
+Animators *principalAnimators = nullptr;
+int principalAnimator = -1;
+int steps = 0;
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -76,174 +92,229 @@ const GLchar *fragmentShaderSource = R"(
  )";
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
-	// Inicialização da GLFW
-	glfwInit();
-
-	// Muita atenção aqui: alguns ambientes não aceitam essas configurações
-	// Você deve adaptar para a versão do OpenGL suportada por sua placa
-	// Sugestão: comente essas linhas de código para desobrir a versão e
-	// depois atualize (por exemplo: 4.5 com 4 e 5)
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	// Ativa a suavização de serrilhado (MSAA) com 8 amostras por pixel
-	glfwWindowHint(GLFW_SAMPLES, 8);
-
-	// Essencial para computadores da Apple
-	// #ifdef __APPLE__
-	//	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-	// #endif
-
-	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "M5 - Sprites -- Arthur Kist Juchem", nullptr, nullptr);
+	// Modo de benchmark (--headless, --frames N...): veja benchmark.h
+	Benchmark bench("FifthModuleTask", argc, argv);
+
+	// Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+	GLFWwindow *window = createWindow(WIDTH, HEIGHT, "M5 - Sprites -- Arthur Kist Juchem", bench.headless());
 	if (!window)
 	{
-		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
-		glfwTerminate();
 		return -1;
 	}
-	glfwMakeContextCurrent(window);
+
+	bench.setup(window, WIDTH, HEIGHT);
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 
-	// GLAD: carrega todos os ponteiros d funções da OpenGL
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cerr << "Falha ao inicializar GLAD" << std::endl;
-		return -1;
-	}
-
-	// Obtendo as informações de versão
-	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
-	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
-	cout << "Renderer: " << renderer << endl;
-	cout << "OpenGL version supported " << version << endl;
-
-	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
-	int width, height;
-	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-
 	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader(vertexShaderSource, fragmentShaderSource);
+	// Handles dos uniforms usados dentro do game loop (resolvidos uma única vez)
+	int modelLoc = shader.uniform("model");
+	int offsetTexLoc = shader.uniform("offsetTex");
 
 	// Carregando uma textura
+	// Texturas compartilhadas: o mesmo arquivo carregado de novo reaproveita a textura
+	TextureCache textures;
 	int imgWidth, imgHeight;
-	GLuint texID = loadTexture("../assets/sprites/Vampires1_Walk_full.png", imgWidth, imgHeight);
 
-	// Gerando um buffer simples, com a geometria de um triângulo
-	principal.nAnimations = 4;
-	principal.nFrames = 6;
-	principal.VAO = setupSprite(principal.nAnimations, principal.nFrames, principal.ds, principal.dt);
+	// A spritesheet do personagem vira um array de texturas, um frame por camada; o
+	// tamanho da grade e as animações vêm do arquivo .anim ao lado da imagem
+	const string walkSheet = "../assets/sprites/Vampires1_Walk_full.png";
+	if (!walkClips.load(AnimationLibrary::sidecarPath(walkSheet)))
+	{
+		glfwTerminate();
+		return -1;
+	}
+	walkDown = walkClips.find("walk_down");
+	walkUp = walkClips.find("walk_up");
+	walkLeft = walkClips.find("walk_left");
+	walkRight = walkClips.find("walk_right");
+	if (walkDown < 0 || walkUp < 0 || walkLeft < 0 || walkRight < 0)
+	{
+		std::cout << "Spritesheet " << walkSheet << " needs the clips walk_down, walk_up, walk_left and walk_right"
+				  << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	principal.nAnimations = walkClips.rows();
+	principal.nFrames = walkClips.columns();
+	int frameWidth, frameHeight;
+	principal.texID = loadTextureArray(walkSheet, principal.nAnimations, principal.nFrames, frameWidth, frameHeight);
 	principal.position = vec3(400.0, 150.0, 0.0);
-	principal.dimensions = vec3(imgWidth / principal.nFrames * 2, imgHeight / principal.nAnimations * 2, 1.0);
-	principal.texID = texID;
-	principal.iAnimation = 1;
-	principal.iFrame = 0;
+	principal.dimensions = vec3(frameWidth * 2, frameHeight * 2, 1.0);
+
+	// --crowd N adiciona N vampiros andando pela tela (teste de carga: a animação
+	// deles não custa nada na CPU)
+	int crowd = 0;
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--crowd") == 0)
+		{
+			crowd = atoi(argv[i + 1]);
+		}
+	}
 
 	Sprite background;
 	background.nAnimations = 1;
 	background.nFrames = 1;
 	background.VAO = setupSprite(background.nAnimations, background.nFrames, background.ds, background.dt);
 	background.position = vec3(400.0, 300.0, 0.0);
-	background.texID = loadTexture("../assets/backgrounds/background_forest.jpg", imgWidth, imgHeight);
+	background.texID = textures.acquire("../assets/backgrounds/background_forest.jpg", imgWidth, imgHeight);
 	background.dimensions = vec3(imgWidth / background.nFrames * 0.95, imgHeight / background.nAnimations * 0.95, 1.0);
 	background.iAnimation = 0;
 	background.iFrame = 0;
 
-	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
+	shader.use(); // Reseta o estado do shader para evitar problemas futuros
 
 	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
-	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
+	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com os passos.
 
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
-	glActiveTexture(GL_TEXTURE0);
+	glstate::activeTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	shader.setInt(shader.uniform("tex_buff"), 0);
 
 	// Matriz de projeção paralela ortográfica
 	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4(shader.uniform("projection"), projection);
+
+	// Os clips vão para a tabela de animações do renderer, na ordem do arquivo (id lá
+	// = firstClip + id na biblioteca), usada pela multidão
+	animated.init(principal.texID, crowd + 1);
+	animated.setProjection(projection);
+	int firstClip = walkClips.upload(animated);
+	if (firstClip < 0)
+	{
+		std::cout << "Animation table is full" << std::endl;
+		glfwTerminate();
+		return -1;
+	}
+	for (int i = 0; i < crowd; i++)
+	{
+		vec3 position(rand() % WIDTH, rand() % HEIGHT, 0.0f);
+		animated.add(position, vec2(principal.dimensions), firstClip + rand() % walkClips.clipCount(),
+					 -(float)(rand() % 1000) / 1000.0f);
+	}
+	principalClip = walkDown;
+	principalSprite = animated.add(principal.position, vec2(principal.dimensions), firstClip + principalClip,
+								   (float)glfwGetTime());
+
+	Animators animators(walkClips);
+	principalAnimators = &animators;
+	principalAnimator = animators.create(principalClip);
+	vector<AnimationHit> hits;
 
-	glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade
-	glDepthFunc(GL_ALWAYS);	 // Testa a cada ciclo
+	glstate::enable(GL_DEPTH_TEST); // Habilita o teste de profundidade
+	glstate::depthFunc(GL_ALWAYS);	 // Testa a cada ciclo
 
-	glEnable(GL_BLEND);								   // Habilita a transparência -- canal alpha
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
+	glstate::enable(GL_BLEND);								   // Habilita a transparência -- canal alpha
+	glstate::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
 
-	double lastTime = 0.0;
-	double deltaT = 0.0;
-	double currTime = glfwGetTime();
-	double FPS = 12.0;
+	// A animação é calculada no shader a partir do tempo: o game loop só controla o
+	// ritmo dos frames (no benchmark headless, sem vsync)
+	GameLoopSettings loopSettings;
+	loopSettings.swapInterval = bench.headless() ? 0 : 1;
+	GameLoop loop(window, loopSettings);
 
 	vec2 offsetTexBg = vec2(0.0, 0.0);
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
+		profiler::beginFrame();
 
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+		profiler::beginScope("glfwPollEvents");
 		glfwPollEvents();
+		profiler::endScope();
+
+		bench.beginFrame();
+
+		loop.beginFrame();
+
+		// Passos do personagem: eventos dos frames alcançados desde o último frame
+		double curr_s = glfwGetTime();
+		double elapsed_s = curr_s - prev_s;
+		prev_s = curr_s;
+		hits.clear();
+		animators.update((float)elapsed_s, &hits);
+		for (const AnimationHit &hit : hits)
+		{
+			if (walkClips.event(hit.event).name == "step")
+			{
+				steps++;
+			}
+		}
+
+		title_countdown_s -= elapsed_s;
+		if (title_countdown_s <= 0.0)
+		{
+			char tmp[256];
+			snprintf(tmp, sizeof(tmp), "M5 - Sprites -- Arthur Kist Juchem -- %d passos", steps);
+			glfwSetWindowTitle(window, tmp);
+			title_countdown_s = 0.1;
+		}
+
+		// Desenho do frame
+		profiler::beginScope("render", true);
 
 		// Limpa o buffer de cor
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+		glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glstate::lineWidth(10);
+		glstate::pointSize(20);
 
+		// O renderer dos vampiros usa outro programa: volta para o do fundo
+		shader.use();
 		mat4 model = mat4(1); // matriz identidade
 		model = translate(model, background.position);
 		model = rotate(model, radians(0.0f), vec3(0.0, 0.0, 1.0));
 		model = scale(model, background.dimensions);
-		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		shader.setMat4(modelLoc, model);
 
 		offsetTexBg.s = background.iFrame * 0.01;
 		offsetTexBg.t = 0.0;
-		glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTexBg.s, offsetTexBg.t);
+		shader.setVec2(offsetTexLoc, offsetTexBg);
 
-		glBindVertexArray(background.VAO);				// Conectando ao buffer de geometria
-		glBindTexture(GL_TEXTURE_2D, background.texID); // Conectando ao buffer de textura
+		glstate::bindVertexArray(background.VAO);				// Conectando ao buffer de geometria
+		glstate::bindTexture(GL_TEXTURE_2D, background.texID); // Conectando ao buffer de textura
 
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-		model = mat4(1);
-		model = translate(model, principal.position);
-		model = rotate(model, radians(0.0f), vec3(0.0, 0.0, 1.0));
-		model = scale(model, principal.dimensions);
-		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		// Todos os vampiros em uma chamada; o frame da multidão sai do tempo e o do
+		// personagem, do animador
+		animated.setLayer(principalSprite, animators.layer(principalAnimator));
+		animated.draw((float)glfwGetTime());
 
-		vec2 offsetTex;
+		profiler::endScope();
 
-		currTime = glfwGetTime();
-		deltaT = currTime - lastTime;
+		bench.endFrame();
 
-		if (deltaT >= 1.0 / FPS)
-		{
-			principal.iFrame = (principal.iFrame + 1) % principal.nFrames; // incremento "circular"
-			lastTime = currTime;
-		}
+		// Troca os buffers da tela
+		profiler::beginScope("glfwSwapBuffers");
+		glfwSwapBuffers(window);
+		profiler::endScope();
 
-		offsetTex.s = principal.iFrame * principal.ds;
-		offsetTex.t = (principal.iAnimation) * principal.dt;
-		glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
+		loop.endFrame();
 
-		glBindVertexArray(principal.VAO);			   // Conectando ao buffer de geometria
-		glBindTexture(GL_TEXTURE_2D, principal.texID); // Conectando ao buffer de textura
+		profiler::endFrame();
+	}
 
-		// Poligono Preenchido - GL_TRIANGLES
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	// Pede pra OpenGL desalocar as texturas
+	textures.clear();
+	animated.release();
+	glDeleteTextures(1, &principal.texID);
+	glstate::forgetTexture(principal.texID);
 
-		// Troca os buffers da tela
-		glfwSwapBuffers(window);
-	}
+	bench.report();
+
+	profiler::shutdown();
 
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
@@ -259,7 +330,7 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 	{
 		if (key == GLFW_KEY_LEFT || key == GLFW_KEY_A)
 		{
-			principal.iAnimation = 3;
+			principalClip = walkLeft;
 			if (principal.position.x >= 0)
 			{
 				principal.position.x -= 10.0f;
@@ -267,7 +338,7 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		}
 		if (key == GLFW_KEY_RIGHT || key == GLFW_KEY_D)
 		{
-			principal.iAnimation = 4;
+			principalClip = walkRight;
 			if (principal.position.x <= WIDTH)
 			{
 				principal.position.x += 10.0f;
@@ -276,7 +347,7 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 		if (key == GLFW_KEY_UP || key == GLFW_KEY_A)
 		{
-			principal.iAnimation = 2;
+			principalClip = walkUp;
 			if (principal.position.y <= HEIGHT)
 			{
 				principal.position.y += 10.0f;
@@ -284,157 +355,15 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		}
 		if (key == GLFW_KEY_DOWN || key == GLFW_KEY_D)
 		{
-			principal.iAnimation = 1;
+			principalClip = walkDown;
 			if (principal.position.y >= 0)
 			{
 				principal.position.y -= 10.0f;
 			}
 		}
-	}
-}
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
+		animated.setPosition(principalSprite, principal.position);
+		// O clip que já está tocando não recomeça (mantém o passo da caminhada)
+		principalAnimators->play(principalAnimator, principalClip);
 	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
-int setupSprite(int nAnimations, int nFrames, float &ds, float &dt)
-{
-
-	ds = 1.0 / (float)nFrames;
-	dt = 1.0 / (float)nAnimations;
-	GLfloat vertices[] = {
-		// x   y    z    s     t
-		-0.5, 0.5, 0.0, 0.0, dt,   // V0
-		-0.5, -0.5, 0.0, 0.0, 0.0, // V1
-		0.5, 0.5, 0.0, ds, dt,	   // V2
-		0.5, -0.5, 0.0, ds, 0.0	   // V3
-	};
-
-	GLuint VBO, VAO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
-
-	return VAO;
 }
-
-int loadTexture(string filePath, int &width, int &height)
-{
-	GLuint texID;
-
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
-}
\ No newline at end of file
@@ -37,15 +37,14 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
-// STB_IMAGE
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 // Protótipo da função de callback de teclado
@@ -55,169 +54,119 @@ struct Sprite
 {
 	vec3 position;
 	vec3 dimensions;
-	GLuint vao;
-	GLuint textId;
+	TextureRegion region; // página do atlas e retângulo da imagem nela
+	int layer; // ordem de pintura: camadas menores primeiro
 };
 
 // Protótipos das funções
-int setupShader();
-int createSpriteVAO();
-Sprite createSprite(vec3 position, vec3 dimensions, GLuint textId);
-int loadTexture(string filePath);
+Sprite createSprite(vec3 position, vec3 dimensions, const TextureRegion &region, int layer);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
 
-// Código fonte do Vertex Shader (em GLSL): ainda hardcoded
-const GLchar *vertexShaderSource = R"(
- #version 400
- layout (location = 0) in vec3 position;
- layout (location = 1) in vec2 texc;
- out vec2 tex_coord;
- uniform mat4 projection;
- uniform mat4 model;
- void main()
- {
-	tex_coord = texc;
-	gl_Position = projection * model * vec4(position.x, position.y, position.z, 1.0);
- }
- )";
-
-// Código fonte do Fragment Shader (em GLSL): ainda hardcoded
-const GLchar *fragmentShaderSource = R"(
- #version 400
- in vec2 tex_coord;
- out vec4 color;
- uniform sampler2D tex_buff;
- void main()
- {
-	 color = texture(tex_buff,tex_coord);
- }
- )";
-
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
-	// Inicialização da GLFW
-	glfwInit();
-
-	// Muita atenção aqui: alguns ambientes não aceitam essas configurações
-	// Você deve adaptar para a versão do OpenGL suportada por sua placa
-	// Sugestão: comente essas linhas de código para desobrir a versão e
-	// depois atualize (por exemplo: 4.5 com 4 e 5)
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	// Ativa a suavização de serrilhado (MSAA) com 8 amostras por pixel
-	glfwWindowHint(GLFW_SAMPLES, 8);
-
-	// Essencial para computadores da Apple
-	// #ifdef __APPLE__
-	//	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-	// #endif
-
-	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
+	// Modo de benchmark (--headless, --frames N...): veja benchmark.h
+	Benchmark bench("FourthModuleTask", argc, argv);
+
+	// Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+	GLFWwindow *window = createWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", bench.headless());
 	if (!window)
 	{
-		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
-		glfwTerminate();
 		return -1;
 	}
-	glfwMakeContextCurrent(window);
+
+	bench.setup(window, WIDTH, HEIGHT);
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 
-	// GLAD: carrega todos os ponteiros d funções da OpenGL
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cerr << "Falha ao inicializar GLAD" << std::endl;
-		return -1;
-	}
-
-	// Obtendo as informações de versão
-	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
-	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
-	cout << "Renderer: " << renderer << endl;
-	cout << "OpenGL version supported " << version << endl;
-
-	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
-	int width, height;
-	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-
-	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	// Batch de sprites: todos os sprites do frame saem de um único VBO
+	SpriteBatch batch;
+	batch.init(64, false); // projeção com y para baixo: sem inverter a coordenada t
 
 	vector<Sprite> sprites;
 
-	sprites.push_back(createSprite(vec3(400, 300, 0.0), vec3(800, 600, 1), loadTexture("../assets/sprites/sky2.png")));
-	sprites.push_back(createSprite(vec3(400, 300, 0.0), vec3(800, 600, 1), loadTexture("../assets/sprites/waterfall.png")));
-	sprites.push_back(createSprite(vec3(150, 95, 0.0), vec3(100, 100, 1), loadTexture("../assets/sprites/moon.png")));
-	sprites.push_back(createSprite(vec3(600, 75, 0.0), vec3(400, 300, 1), loadTexture("../assets/sprites/birds.png")));
-	sprites.push_back(createSprite(vec3(300, 85, 0.0), vec3(400, 300, 1), loadTexture("../assets/sprites/birds.png")));
-	sprites.push_back(createSprite(vec3(300, 400, 0.0), vec3(200, 200, 1), loadTexture("../assets/sprites/boat.png")));
-	sprites.push_back(createSprite(vec3(600, 400, 0.0), vec3(150, 100, 1), loadTexture("../assets/sprites/dolphin.png")));
-	
-	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
+	// Todas as imagens da cena em um atlas: os sprites compartilham a textura e o
+	// batch desenha a página inteira de uma vez (birds.png é carregada uma só vez)
+	TextureAtlas atlas;
+	atlas.build({"../assets/sprites/sky2.png", "../assets/sprites/waterfall.png", "../assets/sprites/moon.png",
+				 "../assets/sprites/birds.png", "../assets/sprites/boat.png", "../assets/sprites/dolphin.png"});
+
+	sprites.push_back(createSprite(vec3(400, 300, 0.0), vec3(800, 600, 1), atlas.region("../assets/sprites/sky2.png"), 0));
+	sprites.push_back(createSprite(vec3(400, 300, 0.0), vec3(800, 600, 1), atlas.region("../assets/sprites/waterfall.png"), 1));
+	sprites.push_back(createSprite(vec3(150, 95, 0.0), vec3(100, 100, 1), atlas.region("../assets/sprites/moon.png"), 2));
+	sprites.push_back(createSprite(vec3(600, 75, 0.0), vec3(400, 300, 1), atlas.region("../assets/sprites/birds.png"), 3));
+	sprites.push_back(createSprite(vec3(300, 85, 0.0), vec3(400, 300, 1), atlas.region("../assets/sprites/birds.png"), 3));
+	sprites.push_back(createSprite(vec3(300, 400, 0.0), vec3(200, 200, 1), atlas.region("../assets/sprites/boat.png"), 4));
+	sprites.push_back(createSprite(vec3(600, 400, 0.0), vec3(150, 100, 1), atlas.region("../assets/sprites/dolphin.png"), 4));
 
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
-	glActiveTexture(GL_TEXTURE0);
+	glstate::activeTexture(GL_TEXTURE0);
 
-	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	glstate::enable(GL_DEPTH_TEST); // Habilita o teste de profundidade
+	glstate::depthFunc(GL_ALWAYS);	 // Testa a cada ciclo
 
-	glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade
-	glDepthFunc(GL_ALWAYS);	 // Testa a cada ciclo
-
-	glEnable(GL_BLEND);								   // Habilita a transparência -- canal alpha
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
+	glstate::enable(GL_BLEND);								   // Habilita a transparência -- canal alpha
+	glstate::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
 
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	batch.setProjection(projection);
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
+		profiler::beginFrame();
+
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+		profiler::beginScope("glfwPollEvents");
 		glfwPollEvents();
+		profiler::endScope();
+
+		bench.beginFrame();
+
+		// Atualização e desenho do frame
+		profiler::beginScope("render", true);
 
 		// Limpa o buffer de cor
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+		glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glstate::lineWidth(10);
+		glstate::pointSize(20);
 
+		// Os sprites são acumulados e desenhados em end(), agrupados por camada e textura
+		batch.begin();
 		for (Sprite &sprite : sprites)
 		{
-			// Matriz de modelo: transformações na geometria (objeto)
-			mat4 model = mat4(1); // matriz identidade
-			// Translação
-			model = translate(model, sprite.position);
-
-			// Escala
-			model = scale(model, sprite.dimensions);
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-			glBindVertexArray(sprite.vao);				 // Conectando ao buffer de geometria
-			glBindTexture(GL_TEXTURE_2D, sprite.textId); // Conectando ao buffer de textura
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			BatchSprite batchSprite;
+			batchSprite.position = sprite.position;
+			batchSprite.dimensions = sprite.dimensions;
+			batchSprite.layer = sprite.layer;
+			batch.draw(batchSprite, sprite.region);
 		}
+		batch.end();
+
+		profiler::endScope();
+
+		bench.endFrame();
 
 		// Troca os buffers da tela
+		profiler::beginScope("glfwSwapBuffers");
 		glfwSwapBuffers(window);
+		profiler::endScope();
+
+		profiler::endFrame();
 	}
-	// Pede pra OpenGL desalocar os buffers
-	for (Sprite &sprite : sprites)
-	{
-		glDeleteVertexArrays(1, &sprite.vao);
-	}
+	// Pede pra OpenGL desalocar as páginas do atlas
+	atlas.release();
+
+	bench.report();
+
+	profiler::shutdown();
 
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
@@ -233,166 +182,14 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
-// Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
-// geometria de um triângulo
-// Apenas atributo coordenada nos vértices
-// 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
-// A função retorna o identificador do VAO
-int createSpriteVAO()
-{
-	// Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
-	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
-	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
-	// Pode ser arazenado em um VBO único ou em VBOs separados
-	GLfloat vertices[] = {
-		// x   y    z    s     t
-		-0.5, 0.5, 0.0, 0.0, 1.0,  // V0 (superior esquerdo)
-		-0.5, -0.5, 0.0, 0.0, 0.0, // V1 (inferior esquerdo)
-		0.5, 0.5, 0.0, 1.0, 1.0,   // V2 (superior direito)
-		0.5, -0.5, 0.0, 1.0, 0.0   // V3 (inferior direito)
-	};
-
-	GLuint VBO, VAO;
-	// Geração do identificador do VBO
-	glGenBuffers(1, &VBO);
-	// Faz a conexão (vincula) do buffer como um buffer de array
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	// Envia os dados do array de floats para o buffer da OpenGl
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// Geração do identificador do VAO (Vertex Array Object)
-	glGenVertexArrays(1, &VAO);
-	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
-	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-	//  Tipo do dado
-	//  Se está normalizado (entre zero e um)
-	//  Tamanho em bytes
-	//  Deslocamento a partir do byte zero
-
-	// Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-	glEnableVertexAttribArray(0);
-
-	// Ponteiro pro atributo 1 - Coordenada de textura s, t
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-	glEnableVertexAttribArray(1);
-
-	// Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-	// atualmente vinculado - para que depois possamos desvincular com segurança
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
-
-	return VAO;
-}
-
-int loadTexture(string filePath)
-{
-	GLuint texID;
-
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int width, height, nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
-}
-
-Sprite createSprite(vec3 position, vec3 dimensions, GLuint textId)
+Sprite createSprite(vec3 position, vec3 dimensions, const TextureRegion &region, int layer)
 {
 	Sprite sprite;
 
 	sprite.position = position;
 	sprite.dimensions = dimensions;
-	sprite.vao = createSpriteVAO();
-	sprite.textId = textId;
+	sprite.region = region;
+	sprite.layer = layer;
 
 	return sprite;
-}
\ No newline at end of file
+}
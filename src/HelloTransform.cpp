@@ -24,16 +24,17 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 #include <cmath>
 
-
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
 int setupGeometry();
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
@@ -62,65 +63,35 @@ const GLchar* fragmentShaderSource = "#version 400\n"
 // Função MAIN
 int main()
 {
-	// Inicialização da GLFW
-	glfwInit();
-
-	//Muita atenção aqui: alguns ambientes não aceitam essas configurações
-	//Você deve adaptar para a versão do OpenGL suportada por sua placa
-	//Sugestão: comente essas linhas de código para desobrir a versão e
-	//depois atualize (por exemplo: 4.5 com 4 e 5)
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	//Essencial para computadores da Apple
-//#ifdef __APPLE__
-//	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-//#endif
-
-	// Criação da janela GLFW
-	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
-	glfwMakeContextCurrent(window);
-
-	// Fazendo o registro da função de callback para a janela GLFW
-	glfwSetKeyCallback(window, key_callback);
-
-	// GLAD: carrega todos os ponteiros d funções da OpenGL
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	// Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+	GLFWwindow *window = createWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana");
+	if (!window)
 	{
-		std::cout << "Failed to initialize GLAD" << std::endl;
-
+		return -1;
 	}
 
-	// Obtendo as informações de versão
-	const GLubyte* renderer = glGetString(GL_RENDERER); /* get renderer string */
-	const GLubyte* version = glGetString(GL_VERSION); /* version as a string */
-	cout << "Renderer: " << renderer << endl;
-	cout << "OpenGL version supported " << version << endl;
-
-	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
-	int width, height;
-	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-
+	// Fazendo o registro da função de callback para a janela GLFW
+	glfwSetKeyCallback(window, key_callback);
 
 	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader(vertexShaderSource, fragmentShaderSource);
+	// Handles dos uniforms usados dentro do game loop (resolvidos uma única vez)
+	int modelLoc = shader.uniform("model");
 
 	// Gerando um buffer simples, com a geometria de um triângulo
 	GLuint VAO = setupGeometry();
 	
-	glUseProgram(shaderID);
+	shader.use();
 
 	// Enviando a cor desejada (vec4) para o fragment shader
 	// Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
 	// que não está nos buffers
-	GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+	int colorLoc = shader.uniform("inputColor");
 
 	//Matriz de projeção paralela ortográfica
 	//mat4 projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
 	mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);  
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	shader.setMat4(shader.uniform("projection"), projection);
 
 	//Matriz de modelo: transformações na geometria (objeto)
 	mat4 model = mat4(1); //matriz identidade
@@ -130,56 +101,87 @@ int main()
 	model = rotate(model,radians(45.0f),vec3(0.0,0.0,1.0));
 	//Escala
 	model = scale(model,vec3(300.0,300.0,1.0));
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+	shader.setMat4(modelLoc, model);
 
+	// A animação é simulada em passos fixos (60 por segundo) e o desenho interpola
+	// entre o passo anterior e o atual, lendo o tempo uma única vez por frame
+	GameLoop loop(window);
+	double animTime = 0.0, prevAnimTime = 0.0;
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
+		profiler::beginFrame();
+
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+		profiler::beginScope("glfwPollEvents");
 		glfwPollEvents();
+		profiler::endScope();
+
+		// Atualização da simulação: zero ou mais passos, conforme o tempo decorrido
+		loop.beginFrame();
+		profiler::beginScope("update");
+		while (loop.step())
+		{
+			prevAnimTime = animTime;
+			animTime += loop.dt();
+		}
+		profiler::endScope();
+		float t = (float)(prevAnimTime + (animTime - prevAnimTime) * loop.alpha());
+
+		// Desenho do frame
+		profiler::beginScope("render", true);
 
 		//Matriz de modelo: transformações na geometria (objeto)
 		model = mat4(1); //matriz identidade
 		//Translação
 		model = translate(model,vec3(400.0,300.0,0.0));
-		model = rotate(model,(float)glfwGetTime(),vec3(0.0,0.0,1.0));
+		model = rotate(model,t,vec3(0.0,0.0,1.0));
 		//Escala
-		model = scale(model,vec3(abs(cos(glfwGetTime())) * 300.0,abs(cos(glfwGetTime())) * 300.0,1.0));
-		glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
+		model = scale(model,vec3(abs(cos(t)) * 300.0,abs(cos(t)) * 300.0,1.0));
+		shader.setMat4(modelLoc, model);
 
 		// Limpa o buffer de cor
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
+		glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glstate::lineWidth(10);
+		glstate::pointSize(20);
 
-		glBindVertexArray(VAO); //Conectando ao buffer de geometria
+		glstate::bindVertexArray(VAO); //Conectando ao buffer de geometria
 
-		glUniform4f(colorLoc, 0.0f, 0.0f, abs(cos(glfwGetTime())) , 1.0f); //enviando cor para variável uniform inputColor
+		shader.setVec4(colorLoc, glm::vec4(0.0f, 0.0f, abs(cos(t)) , 1.0f)); //enviando cor para variável uniform inputColor
 		// Chamada de desenho - drawcall
 		// Poligono Preenchido - GL_TRIANGLES
 		glDrawArrays(GL_TRIANGLES, 0, 3);
 		
 		//Desenho com contorno (linhas)
-		//glUniform4f(colorLoc, 1.0f, 0.0f, 1.0f, 1.0f); //enviando cor para variável uniform inputColor
+		//shader.setVec4(colorLoc, glm::vec4(1.0f, 0.0f, 1.0f, 1.0f)); //enviando cor para variável uniform inputColor
 		//glDrawArrays(GL_LINE_LOOP, 0, 3); //Desenha T0
 		//glDrawArrays(GL_LINE_LOOP, 3, 3); //Desenha T1
 
 		//Desenho só dos pontos (vértices)
-		//glUniform4f(colorLoc, 1.0f, 1.0f, 0.0f, 1.0f); //enviando cor para variável uniform inputColor
+		//shader.setVec4(colorLoc, glm::vec4(1.0f, 1.0f, 0.0f, 1.0f)); //enviando cor para variável uniform inputColor
 		//glDrawArrays(GL_POINTS, 0, 6); 
 
+		glstate::bindVertexArray(0); //Desconectando o buffer de geometria
 
-		glBindVertexArray(0); //Desconectando o buffer de geometria
+		profiler::endScope();
 
 		// Troca os buffers da tela
+		profiler::beginScope("glfwSwapBuffers");
 		glfwSwapBuffers(window);
+		profiler::endScope();
+
+		loop.endFrame();
+
+		profiler::endFrame();
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
+
+	profiler::shutdown();
+
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -194,54 +196,6 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 		glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-//Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-// shader simples e único neste exemplo de código
-// O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-// fragmentShader source no iniçio deste arquivo
-// A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success) {
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a 
 // geometria de um triângulo
 // Apenas atributo coordenada nos vértices
@@ -273,7 +227,7 @@ int setupGeometry()
 	glGenVertexArrays(1, &VAO);
 	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
 	// e os ponteiros para os atributos 
-	glBindVertexArray(VAO);
+	glstate::bindVertexArray(VAO);
 	//Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando: 
 	// Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
 	// Numero de valores que o atributo tem (por ex, 3 coordenadas xyz) 
@@ -289,8 +243,7 @@ int setupGeometry()
 	glBindBuffer(GL_ARRAY_BUFFER, 0); 
 
 	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0); 
+	glstate::bindVertexArray(0); 
 
 	return VAO;
 }
-
@@ -37,24 +37,21 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
-// STB_IMAGE
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
 int createVAO();
-int loadTexture(string filePath);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -91,67 +88,33 @@ const GLchar *fragmentShaderSource = R"(
  }
  )";
 
-struct Layer {
-    GLuint textureID;
-    float speedFactor;
-    float offsetX = 0.0;
-    int width;
-    int height;
-};
-
-vector<Layer> layers;
+// Fundo com todas as camadas compostas num único passe e a posição da câmera
+ParallaxRenderer parallax;
+float cameraX = 0.0;
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
-	// Inicialização da GLFW
-	glfwInit();
-
-	// Muita atenção aqui: alguns ambientes não aceitam essas configurações
-	// Você deve adaptar para a versão do OpenGL suportada por sua placa
-	// Sugestão: comente essas linhas de código para desobrir a versão e
-	// depois atualize (por exemplo: 4.5 com 4 e 5)
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-	// Ativa a suavização de serrilhado (MSAA) com 8 amostras por pixel
-	glfwWindowHint(GLFW_SAMPLES, 8);
-
-	// Criação da janela GLFW
-	GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Atividade Vivencial - M4", nullptr, nullptr);
+	// Modo de benchmark (--headless, --frames N...): veja benchmark.h
+	Benchmark bench("InPersonFourthModuleTask", argc, argv);
+
+	// Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+	GLFWwindow *window = createWindow(WIDTH, HEIGHT, "Atividade Vivencial - M4", bench.headless());
 	if (!window)
 	{
-		std::cerr << "Falha ao criar a janela GLFW" << std::endl;
-		glfwTerminate();
 		return -1;
 	}
-	glfwMakeContextCurrent(window);
+
+	bench.setup(window, WIDTH, HEIGHT);
 
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 
-	// GLAD: carrega todos os ponteiros d funções da OpenGL
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		std::cerr << "Falha ao inicializar GLAD" << std::endl;
-		return -1;
-	}
-
-	// Obtendo as informações de versão
-	const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
-	const GLubyte *version = glGetString(GL_VERSION);	/* version as a string */
-	cout << "Renderer: " << renderer << endl;
-	cout << "OpenGL version supported " << version << endl;
-
-	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
-	int width, height;
-	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-
 	// Compilando e buildando o programa de shader
-	GLuint shaderID = setupShader();
+	ShaderProgram shader(vertexShaderSource, fragmentShaderSource);
+	// Handles dos uniforms usados dentro do game loop (resolvidos uma única vez)
+	int modelLoc = shader.uniform("model");
+	int offsetXLoc = shader.uniform("offsetX");
     GLuint VAO = createVAO();
 
 	const string textures[] = {
@@ -168,75 +131,112 @@ int main()
 
 	float speeds[] = { 0.1, 0.2, 0.25, 0.3, 0.35, 0.4, 0.5, 0.8, 1.0 };
 
+	// Com o pacote gerado pelo alvo cook_assets, as camadas são enviadas direto do
+	// arquivo mapeado (já decodificadas e com mipmaps). Sem ele, são decodificadas
+	// em paralelo antes do primeiro frame; o sprite continua em segundo plano
+	TexturePack pack;
+	pack.open("textures.tpk");
+	AsyncTextureLoader loader;
+
+	vector<ParallaxLayer> layers;
     for (int i = 0; i < 9; i++) {
-        Layer layer;
-        layer.textureID = loadTexture(textures[i]);
+        ParallaxLayer layer;
+        layer.path = textures[i];
         layer.speedFactor = speeds[i];
-        layer.width = 800;
-        layer.height = 600  ;
         layers.push_back(layer);
     }
+	if (!parallax.init(layers, &pack))
+	{
+		cout << "Parallax background not loaded" << endl;
+	}
 
-	GLuint sprite = loadTexture("../assets/sprites/waterbear.png");
+	const string spritePath = "../assets/sprites/waterbear.png";
+	GLuint sprite = pack.contains(spritePath) ? pack.loadTexture(spritePath) : loader.load(spritePath);
+	pack.close(); // os dados já estão na GPU
 
-	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
+	shader.use(); // Reseta o estado do shader para evitar problemas futuros
 
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
-	glActiveTexture(GL_TEXTURE0);
+	glstate::activeTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	shader.setInt(shader.uniform("tex_buff"), 0);
 
-	glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade
-	glDepthFunc(GL_ALWAYS);	 // Testa a cada ciclo
+	glstate::enable(GL_DEPTH_TEST); // Habilita o teste de profundidade
+	glstate::depthFunc(GL_ALWAYS);	 // Testa a cada ciclo
 
-	glEnable(GL_BLEND);								   // Habilita a transparência -- canal alpha
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
+	glstate::enable(GL_BLEND);								   // Habilita a transparência -- canal alpha
+	glstate::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
 
 	mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
-    GLint textureWidthLoc = glGetUniformLocation(shaderID, "textureWidth");
+	shader.setMat4(shader.uniform("projection"), projection);
+	shader.setFloat(shader.uniform("textureWidth"), (float)WIDTH);
+
+	// O fundo cobre a janela inteira: a largura dela corresponde à imagem toda
+	parallax.setProjection(projection);
+	parallax.setRect(0.0, 0.0, (float)WIDTH, (float)HEIGHT);
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
+		profiler::beginFrame();
+
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+		profiler::beginScope("glfwPollEvents");
 		glfwPollEvents();
+		profiler::endScope();
+
+		bench.beginFrame();
+
+		// Atualização e desenho do frame
+		profiler::beginScope("render", true);
+
+		// Envia para a GPU as texturas que já terminaram de ser decodificadas
+		loader.update();
 
 		// Limpa o buffer de cor
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+		glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glBindVertexArray(VAO);
-		glLineWidth(10);
-		glPointSize(20);
-
-         mat4 model = mat4(1.0);
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+		// Todas as camadas de uma vez, da frente para trás
+		parallax.setScroll(cameraX);
+		parallax.draw();
 
-		for (Layer &layer : layers)
-		{
-            glBindTexture(GL_TEXTURE_2D, layer.textureID); // Conectando ao buffer de textura
-            glUniform1f(glGetUniformLocation(shaderID, "offsetX"), layer.offsetX);
-            glUniform1f(textureWidthLoc, (float)layer.width);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-		}
+        shader.use();
+        glstate::bindVertexArray(VAO);
+		glstate::lineWidth(10);
+		glstate::pointSize(20);
 
         mat4 model2 = mat4(1.0);
         model2 = glm::translate(model2, vec3(400.0, 525.0, 0.0));
         model2 = glm::scale(model2, glm::vec3(100.0 / 800.0, 100.0 / 600.0, 1.0));
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model2));
+        shader.setMat4(modelLoc, model2);
         
-        glBindTexture(GL_TEXTURE_2D, sprite);
-        glUniform1f(glGetUniformLocation(shaderID, "offsetX"), 0.0);
+        glstate::bindTexture(GL_TEXTURE_2D, sprite);
+        shader.setFloat(offsetXLoc, 0.0);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
+		profiler::endScope();
+
+		bench.endFrame();
+
 		// Troca os buffers da tela
+		profiler::beginScope("glfwSwapBuffers");
 		glfwSwapBuffers(window);
+		profiler::endScope();
+
+		profiler::endFrame();
 	}
 
+	parallax.release();
+	loader.release();
+
+	bench.report();
+
+	profiler::shutdown();
+
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -249,71 +249,16 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 {
     if (action == GLFW_PRESS || action == GLFW_REPEAT) {
         double delta = 10.0;
+        // Cada camada anda delta * speedFactor (no shader do parallax)
         if (key == GLFW_KEY_LEFT || key == GLFW_KEY_A) {
-            for (auto& layer : layers) {
-                layer.offsetX -= delta * layer.speedFactor;
-            }
+            cameraX -= delta;
         }
         if (key == GLFW_KEY_RIGHT || key == GLFW_KEY_D) {
-            for (auto& layer : layers) {
-                layer.offsetX += delta * layer.speedFactor;
-            }
+            cameraX += delta;
         }
     }
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-	// Vertex shader
-	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-	glCompileShader(vertexShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	GLint success;
-	GLchar infoLog[512];
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Fragment shader
-	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-	glCompileShader(fragmentShader);
-	// Checando erros de compilação (exibição via log no terminal)
-	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-	if (!success)
-	{
-		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	// Linkando os shaders e criando o identificador do programa de shader
-	GLuint shaderProgram = glCreateProgram();
-	glAttachShader(shaderProgram, vertexShader);
-	glAttachShader(shaderProgram, fragmentShader);
-	glLinkProgram(shaderProgram);
-	// Checando por erros de linkagem
-	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-	if (!success)
-	{
-		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-		std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-				  << infoLog << std::endl;
-	}
-	glDeleteShader(vertexShader);
-	glDeleteShader(fragmentShader);
-
-	return shaderProgram;
-}
-
 // Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
 // geometria de um triângulo
 // Apenas atributo coordenada nos vértices
@@ -344,7 +289,7 @@ int createVAO()
 	glGenVertexArrays(1, &VAO);
 	// Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
 	// e os ponteiros para os atributos
-	glBindVertexArray(VAO);
+	glstate::bindVertexArray(VAO);
 	// Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
 	//  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
 	//  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
@@ -366,49 +311,7 @@ int createVAO()
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-	glBindVertexArray(0);
+	glstate::bindVertexArray(0);
 
 	return VAO;
 }
-
-int loadTexture(string filePath)
-{
-	GLuint texID;
-
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-	int width, height, nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	stbi_image_free(data);
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-
-	return texID;
-}
\ No newline at end of file
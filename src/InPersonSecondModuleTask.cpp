@@ -19,6 +19,9 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 struct Triangle {
@@ -29,8 +32,6 @@ struct Triangle {
     float b;
 };
 
-
-int setupShader();
 GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -61,41 +62,18 @@ vector<vec2> vertices;
 
 int main()
 {
-    glfwInit();
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_SAMPLES, 8);
-
-
-    GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Exec Triângulos! -- Arthur", nullptr, nullptr);
+    // Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+    GLFWwindow *window = createWindow(WIDTH, HEIGHT, "Exec Triângulos! -- Arthur");
     if (!window)
     {
-        std::cerr << "Falha ao criar a janela GLFW" << std::endl;
-        glfwTerminate();
-        return -1;
-    }
-    glfwMakeContextCurrent(window);
-
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cerr << "Falha ao inicializar GLAD" << std::endl;
         return -1;
     }
-
-    const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
-    const GLubyte *version = glGetString(GL_VERSION);   /* version as a string */
-    cout << "Renderer: " << renderer << endl;
-    cout << "OpenGL version supported " << version << endl;
-
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glViewport(0, 0, width, height);
     
-    GLuint shaderID = setupShader();
+    ShaderProgram shader(vertexShaderSource, fragmentShaderSource);
+    
+    // Handles dos uniforms usados dentro do game loop (resolvidos uma única vez)
+    
+    int modelLoc = shader.uniform("model");
     
     GLuint VAO = createTriangle(-0.5, -0.5, 0.5, -0.5, 0.0, 0.5);
 
@@ -107,16 +85,23 @@ int main()
     mainTriangle.b = 0.4; 
     triangles.push_back(mainTriangle);
 
-    glUseProgram(shaderID);
+    shader.use();
 
-    GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+    int colorLoc = shader.uniform("inputColor");
 
     mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+    shader.setMat4(shader.uniform("projection"), projection);
 
     while (!glfwWindowShouldClose(window))
     {
+        profiler::beginFrame();
+
+        profiler::beginScope("glfwPollEvents");
         glfwPollEvents();
+        profiler::endScope();
+
+        // Atualização e desenho do frame
+        profiler::beginScope("render", true);
 
         glfwSetMouseButtonCallback(window, mouse_button_callback);
 
@@ -124,13 +109,13 @@ int main()
             glfwSetWindowShouldClose(window, GLFW_TRUE);
         }
 
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
         
-        glLineWidth(10);
-        glPointSize(20);
+        glstate::lineWidth(10);
+        glstate::pointSize(20);
 
-        glBindVertexArray(VAO);
+        glstate::bindVertexArray(VAO);
 
         for (const auto& triangle : triangles) {
             mat4 model = mat4(1); // matriz identidade
@@ -140,69 +125,31 @@ int main()
             model = rotate(model, radians(180.0f), vec3(0.0, 0.0, 1.0));
             // Escala
             model = scale(model, vec3(100.0, 100.0, 1));
-            glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+            shader.setMat4(modelLoc, model);
 
-            glUniform4f(colorLoc, triangle.r, triangle.g, triangle.b, 1.0f);
+            shader.setVec4(colorLoc, glm::vec4(triangle.r, triangle.g, triangle.b, 1.0f));
             glDrawArrays(GL_TRIANGLES, 0, 3);
         }
 
-        glBindVertexArray(0); // Desconectando o buffer de geometria
+        glstate::bindVertexArray(0); // Desconectando o buffer de geometria
+
+        profiler::endScope();
+
+        profiler::beginScope("glfwSwapBuffers");
         glfwSwapBuffers(window);
+        profiler::endScope();
+
+        profiler::endFrame();
     }
     
     glDeleteVertexArrays(1, &VAO);
 
+    profiler::shutdown();
+
     glfwTerminate();
     return 0;
 }
 
-int setupShader()
-{
-    // Vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // Checando erros de compilação (exibição via log no terminal)
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    // Fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // Checando erros de compilação (exibição via log no terminal)
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    // Linkando os shaders e criando o identificador do programa de shader
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // Checando por erros de linkagem
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return shaderProgram;
-}
-
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
     {
@@ -238,7 +185,7 @@ GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2
     GLuint VAO, VBO;
 
     glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    glstate::bindVertexArray(VAO);
 
     glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -247,7 +194,7 @@ GLuint createTriangle(float x0, float y0, float x1, float y1, float x2, float y2
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
     glEnableVertexAttribArray(0);
 
-    glBindVertexArray(0);
+    glstate::bindVertexArray(0);
 
     return VAO;
-}
\ No newline at end of file
+}
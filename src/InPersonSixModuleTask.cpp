@@ -12,15 +12,14 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
-// STB_IMAGE
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 int selectedTileMapLine = 5, selectedTileMapColumn = 3;
@@ -52,11 +51,9 @@ struct Tile
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 
 // Protótipos das funções
-int setupShader();
-int setupSprite();
-int setupTile(int nTiles, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
-void desenharMapa(GLuint shaderID);
+void setupTilemap(GLuint texID, const Tile &tile, const mat4 &projection);
+void atualizarMapa();
+void desenharMapa(ShaderProgram &shader);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -90,6 +87,40 @@ const GLchar *fragmentShaderSource = R"(
  }
  )";
 
+// Vertex Shader do tilemap: cada instância é um tile (linha i, coluna j, índice no tileset)
+// e a posição isométrica é calculada aqui, sem matriz de modelo por tile
+const GLchar *tilemapVertexShaderSource = R"(
+ #version 400
+ layout (location = 0) in vec3 position;
+ layout (location = 1) in vec2 texc;
+ layout (location = 2) in vec3 tileInstance; // i, j, iTile
+ out vec2 tex_coord;
+ uniform mat4 projection;
+ uniform vec2 origin;
+ uniform vec2 tileDimensions;
+ uniform float ds;
+ void main()
+ {
+	float x = origin.x + (tileInstance.y - tileInstance.x) * tileDimensions.x / 2.0;
+	float y = origin.y + (tileInstance.y + tileInstance.x) * tileDimensions.y / 2.0;
+	tex_coord = vec2(texc.s + tileInstance.z * ds, 1.0 - texc.t);
+	gl_Position = projection * vec4(position.xy * tileDimensions + vec2(x, y), position.z, 1.0);
+ }
+ )";
+
+// Fragment Shader do tilemap: o deslocamento no tileset já vem do vertex shader
+const GLchar *tilemapFragmentShaderSource = R"(
+ #version 400
+ in vec2 tex_coord;
+ out vec4 color;
+ uniform sampler2D tex_buff;
+
+ void main()
+ {
+	 color = texture(tex_buff,tex_coord);
+ }
+ )";
+
 #define TILEMAP_WIDTH 5
 #define TILEMAP_HEIGHT 5
 int map[5][5] = {
@@ -101,69 +132,44 @@ int map[5][5] = {
 
 vector<Tile> tileset;
 
+// Mapa desenhado com uma única chamada instanciada
+struct Tilemap
+{
+    GLuint VAO;
+    GLuint instanceVBO; // i, j e iTile de cada célula do mapa
+    ShaderProgram shader;
+    GLuint texID;
+    bool dirty = true; // o mapa mudou desde o último upload
+};
+
+Tilemap tilemap;
+
 // Função MAIN
 int main()
 {
-    // Inicialização da GLFW
-    glfwInit();
-
-    // Muita atenção aqui: alguns ambientes não aceitam essas configurações
-    // Você deve adaptar para a versão do OpenGL suportada por sua placa
-    // Sugestão: comente essas linhas de código para desobrir a versão e
-    // depois atualize (por exemplo: 4.5 com 4 e 5)
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // Ativa a suavização de serrilhado (MSAA) com 8 amostras por pixel
-    glfwWindowHint(GLFW_SAMPLES, 8);
-
-    // Essencial para computadores da Apple
-    // #ifdef __APPLE__
-    //	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    // #endif
-
-    // Criação da janela GLFW
-    GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Atividade vivencial - M6", nullptr, nullptr);
+    // Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+    GLFWwindow *window = createWindow(WIDTH, HEIGHT, "Atividade vivencial - M6");
     if (!window)
     {
-        std::cerr << "Falha ao criar a janela GLFW" << std::endl;
-        glfwTerminate();
         return -1;
     }
-    glfwMakeContextCurrent(window);
 
     // Fazendo o registro da função de callback para a janela GLFW
     glfwSetKeyCallback(window, key_callback);
 
-    // GLAD: carrega todos os ponteiros d funções da OpenGL
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cerr << "Falha ao inicializar GLAD" << std::endl;
-        return -1;
-    }
-
-    // Obtendo as informações de versão
-    const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
-    const GLubyte *version = glGetString(GL_VERSION);   /* version as a string */
-    cout << "Renderer: " << renderer << endl;
-    cout << "OpenGL version supported " << version << endl;
-
-    // Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glViewport(0, 0, width, height);
-
     // Compilando e buildando o programa de shader
-    GLuint shaderID = setupShader();
+    ShaderProgram shader(vertexShaderSource, fragmentShaderSource);
+    // Handles dos uniforms usados dentro do game loop (resolvidos uma única vez)
+    int modelLoc = shader.uniform("model");
 
     // Carregando uma textura
+    // Texturas compartilhadas: o mesmo arquivo carregado de novo reaproveita a textura
+    TextureCache textures;
     int imgWidth, imgHeight;
     // GLuint texID = loadTexture("../assets/sprites/Vampires1_Walk_full.png",imgWidth,imgHeight);
-    GLuint texID = loadTexture("../assets/tilesets/tilesetIso.png", imgWidth, imgHeight);
+    GLuint texID = textures.acquire("../assets/tilesets/tilesetIso.png", imgWidth, imgHeight);
 
-    GLuint principalTexID = loadTexture("../assets/sprites/Vampirinho.png", imgWidth, imgHeight);
+    GLuint principalTexID = textures.acquire("../assets/sprites/Vampirinho.png", imgWidth, imgHeight);
     // Gerando um buffer simples, com a geometria de um triângulo
     Sprite principal;
     principal.VAO = setupSprite();
@@ -182,7 +188,7 @@ int main()
         tileset.push_back(tile);
     }
 
-    glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
+    shader.use(); // Reseta o estado do shader para evitar problemas futuros
 
     double prev_s = glfwGetTime();  // Define o "tempo anterior" inicial.
     double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
@@ -190,41 +196,51 @@ int main()
     float colorValue = 0.0;
 
     // Ativando o primeiro buffer de textura do OpenGL
-    glActiveTexture(GL_TEXTURE0);
+    glstate::activeTexture(GL_TEXTURE0);
 
     // Criando a variável uniform pra mandar a textura pro shader
-    glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+    shader.setInt(shader.uniform("tex_buff"), 0);
 
     // Matriz de projeção paralela ortográfica
     mat4 projection = ortho(0.0, 800.0, 0.0, 600.0, -1.0, 1.0);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+    shader.setMat4(shader.uniform("projection"), projection);
+
+    // Configura o tilemap instanciado (usa seu próprio programa de shader)
+    setupTilemap(texID, tileset[0], projection);
+    shader.use();
 
-    glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade
-    glDepthFunc(GL_ALWAYS);  // Testa a cada ciclo
+    glstate::enable(GL_DEPTH_TEST); // Habilita o teste de profundidade
+    glstate::depthFunc(GL_ALWAYS);  // Testa a cada ciclo
 
-    glEnable(GL_BLEND);                                // Habilita a transparência -- canal alpha
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
+    glstate::enable(GL_BLEND);                                // Habilita a transparência -- canal alpha
+    glstate::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Seta função de transparência
 
-    double lastTime = 0.0;
-    double deltaT = 0.0;
-    double currTime = glfwGetTime();
-    double FPS = 12.0;
+    // Sem animação em passo fixo: o game loop só controla o ritmo dos frames (vsync)
+    GameLoop loop(window);
 
     // Loop da aplicação - "game loop"
     while (!glfwWindowShouldClose(window))
     {
+        profiler::beginFrame();
+        loop.beginFrame();
+
         // Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+        profiler::beginScope("glfwPollEvents");
         glfwPollEvents();
+        profiler::endScope();
+
+        // Atualização e desenho do frame
+        profiler::beginScope("render", true);
 
         // Limpa o buffer de cor
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+        glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glLineWidth(10);
-        glPointSize(20);
+        glstate::lineWidth(10);
+        glstate::pointSize(20);
 
         // Desenhar o mapa
-        desenharMapa(shaderID);
+        desenharMapa(shader);
 
         //---------------------------------------------------------------------
         // Desenho do principal
@@ -253,20 +269,32 @@ int main()
         model = translate(model, position);
         model = rotate(model, radians(0.0f), vec3(0.0, 0.0, 1.0));
         model = scale(model, principal.dimensions);
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+        shader.setMat4(modelLoc, model);
 
-        glBindVertexArray(principal.VAO);              // Conectando ao buffer de geometria
-        glBindTexture(GL_TEXTURE_2D, principal.texID); // Conectando ao buffer de textura
+        glstate::bindVertexArray(principal.VAO);              // Conectando ao buffer de geometria
+        glstate::bindTexture(GL_TEXTURE_2D, principal.texID); // Conectando ao buffer de textura
 
         // Chamada de desenho - drawcall
         // Poligono Preenchido - GL_TRIANGLES
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         //---------------------------------------------------------------------------
 
+        profiler::endScope();
+
         // Troca os buffers da tela
+        profiler::beginScope("glfwSwapBuffers");
         glfwSwapBuffers(window);
+        profiler::endScope();
+
+        loop.endFrame();
+        profiler::endFrame();
     }
 
+    // Pede pra OpenGL desalocar as texturas
+    textures.clear();
+
+    profiler::shutdown();
+
     // Finaliza a execução da GLFW, limpando os recursos alocados por ela
     glfwTerminate();
     return 0;
@@ -326,248 +354,85 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
     std::cout << "----" << std::endl;
 }
 
-// Esta função está bastante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
+void setupTilemap(GLuint texID, const Tile &tile, const mat4 &projection)
 {
-    // Vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // Checando erros de compilação (exibição via log no terminal)
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    // Fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // Checando erros de compilação (exibição via log no terminal)
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    // Linkando os shaders e criando o identificador do programa de shader
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // Checando por erros de linkagem
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // dá pra fazer um cálculo usando tilemap_width e tilemap_height
+    float x0 = 400;
+    float y0 = 100;
 
-    return shaderProgram;
-}
+    tilemap.shader = ShaderProgram(tilemapVertexShaderSource, tilemapFragmentShaderSource);
+    tilemap.texID = texID;
 
-// Esta função está bastante harcoded - objetivo é criar os buffers que armazenam a
-// geometria de um triângulo
-// Apenas atributo coordenada nos vértices
-// 1 VBO com as coordenadas, VAO com apenas 1 ponteiro para atributo
-// A função retorna o identificador do VAO
-int setupSprite()
-{
-    // Aqui setamos as coordenadas x, y e z do triângulo e as armazenamos de forma
-    // sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
-    // Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
-    // Pode ser arazenado em um VBO único ou em VBOs separados
-    GLfloat vertices[] = {
-        // x   y    z    s     t
-        -0.5, 0.5, 0.0, 0.0, 1.0,  // V0
-        -0.5, -0.5, 0.0, 0.0, 0.0, // V1
-        0.5, 0.5, 0.0, 1.0, 1.0,   // V2
-        0.5, -0.5, 0.0, 1.0, 0.0   // V3
-    };
-
-    GLuint VBO, VAO;
-    // Geração do identificador do VBO
-    glGenBuffers(1, &VBO);
-    // Faz a conexão (vincula) do buffer como um buffer de array
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // Envia os dados do array de floats para o buffer da OpenGl
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // Geração do identificador do VAO (Vertex Array Object)
-    glGenVertexArrays(1, &VAO);
-    // Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-    // e os ponteiros para os atributos
-    glBindVertexArray(VAO);
-    // Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-    //  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-    //  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-    //  Tipo do dado
-    //  Se está normalizado (entre zero e um)
-    //  Tamanho em bytes
-    //  Deslocamento a partir do byte zero
-
-    // Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-    glEnableVertexAttribArray(0);
-
-    // Ponteiro pro atributo 1 - Coordenada de textura s, t
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    // Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-    // atualmente vinculado - para que depois possamos desvincular com segurança
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // Todos os tiles compartilham a mesma geometria do losango
+    float ds, dt;
+    tilemap.VAO = setupTile(7, ds, dt);
 
-    // Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-    glBindVertexArray(0);
+    glGenBuffers(1, &tilemap.instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, tilemap.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, TILEMAP_HEIGHT * TILEMAP_WIDTH * 3 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
 
-    return VAO;
-}
+    glstate::bindVertexArray(tilemap.VAO);
 
-int setupTile(int nTiles, float &ds, float &dt)
-{
+    // Ponteiro pro atributo 2 - Dados da instância i, j, iTile (avança uma vez por tile, não por vértice)
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
 
-    ds = 1.0 / (float)nTiles;
-    dt = 1.0;
-
-    // Como eu prefiro escalar depois, th e tw serão 1.0
-    float th = 1.0, tw = 1.0;
-
-    GLfloat vertices[] = {
-        // x   y    z    s     t
-        0.0, th / 2.0f, 0.0, 0.0, dt / 2.0f, // A
-        tw / 2.0f, th, 0.0, ds / 2.0f, dt,   // B
-        tw / 2.0f, 0.0, 0.0, ds / 2.0f, 0.0, // D
-        tw, th / 2.0f, 0.0, ds, dt / 2.0f    // C
-    };
-
-    GLuint VBO, VAO;
-    // Geração do identificador do VBO
-    glGenBuffers(1, &VBO);
-    // Faz a conexão (vincula) do buffer como um buffer de array
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // Envia os dados do array de floats para o buffer da OpenGl
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // Geração do identificador do VAO (Vertex Array Object)
-    glGenVertexArrays(1, &VAO);
-    // Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-    // e os ponteiros para os atributos
-    glBindVertexArray(VAO);
-    // Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-    //  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-    //  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-    //  Tipo do dado
-    //  Se está normalizado (entre zero e um)
-    //  Tamanho em bytes
-    //  Deslocamento a partir do byte zero
-
-    // Ponteiro pro atributo 0 - Posição - coordenadas x, y, z
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-    glEnableVertexAttribArray(0);
-
-    // Ponteiro pro atributo 1 - Coordenada de textura s, t
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    // Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-    // atualmente vinculado - para que depois possamos desvincular com segurança
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-    glBindVertexArray(0);
-
-    return VAO;
+    glstate::bindVertexArray(0);
+
+    // Uniforms constantes do mapa: enviados uma única vez
+    ShaderProgram &shader = tilemap.shader;
+    shader.use();
+    shader.setInt(shader.uniform("tex_buff"), 0);
+    shader.setMat4(shader.uniform("projection"), projection);
+    shader.setVec2(shader.uniform("origin"), vec2(x0, y0));
+    shader.setVec2(shader.uniform("tileDimensions"), vec2(tile.dimensions.x, tile.dimensions.y));
+    shader.setFloat(shader.uniform("ds"), tile.ds);
+
+    tilemap.dirty = true;
 }
 
-int loadTexture(string filePath, int &width, int &height)
+// Reenvia os dados de instância do mapa para a GPU
+void atualizarMapa()
 {
-    GLuint texID;
-
-    // Gera o identificador da textura na memória
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    int nrChannels;
-
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+    GLfloat instances[TILEMAP_HEIGHT * TILEMAP_WIDTH * 3];
 
-    if (data)
+    int n = 0;
+    for (int i = 0; i < TILEMAP_HEIGHT; i++)
     {
-        if (nrChannels == 3) // jpg, bmp
-        {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        }
-        else // png
+        for (int j = 0; j < TILEMAP_WIDTH; j++)
         {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            instances[n++] = i;
+            instances[n++] = j;
+            instances[n++] = tileset[map[i][j]].iTile;
         }
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture" << std::endl;
     }
 
-    stbi_image_free(data);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, tilemap.instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(instances), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    return texID;
+    tilemap.dirty = false;
 }
 
-void desenharMapa(GLuint shaderID)
+void desenharMapa(ShaderProgram &shader)
 {
-    // dá pra fazer um cálculo usando tilemap_width e tilemap_height
-    float x0 = 400;
-    float y0 = 100;
-
-    for (int i = 0; i < TILEMAP_HEIGHT; i++)
+    // Só reenvia as instâncias quando o mapa foi alterado
+    if (tilemap.dirty)
     {
-        for (int j = 0; j < TILEMAP_WIDTH; j++)
-        {
-            // Matriz de transformaçao do objeto - Matriz de modelo
-            mat4 model = mat4(1); // matriz identidade
-
-            Tile curr_tile = tileset[map[i][j]];
-
-            float x = x0 + (j - i) * curr_tile.dimensions.x / 2.0;
-            float y = y0 + (j + i) * curr_tile.dimensions.y / 2.0;
-
-            model = translate(model, vec3(x, y, 0.0));
-            model = scale(model, curr_tile.dimensions);
-            glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+        atualizarMapa();
+    }
 
-            vec2 offsetTex;
+    tilemap.shader.use();
 
-            offsetTex.s = curr_tile.iTile * curr_tile.ds;
-            offsetTex.t = 0.0;
-            glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
+    glstate::bindVertexArray(tilemap.VAO);              // Conectando ao buffer de geometria
+    glstate::bindTexture(GL_TEXTURE_2D, tilemap.texID); // Conectando ao buffer de textura
 
-            glBindVertexArray(curr_tile.VAO);              // Conectando ao buffer de geometria
-            glBindTexture(GL_TEXTURE_2D, curr_tile.texID); // Conectando ao buffer de textura
+    // Chamada de desenho única para todos os tiles - a ordem das instâncias
+    // (linha a linha) preserva a ordem de pintura do desenho tile a tile
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, TILEMAP_HEIGHT * TILEMAP_WIDTH);
 
-            // Chamada de desenho - drawcall
-            // Poligono Preenchido - GL_TRIANGLES
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-    }
+    // Volta para o shader dos sprites
+    shader.use();
 }
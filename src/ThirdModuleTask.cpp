@@ -25,6 +25,9 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Engine (shader, textura, malhas e janela)
+#include <gl_utils.h>
+
 using namespace glm;
 
 #include <cmath>
@@ -34,8 +37,6 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 void mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
 
 // Protótipos das funções
-GLuint createSquare();
-int setupShader();
 void eliminatesSimilar();
 void createGame();
 void restartGame();
@@ -94,81 +95,59 @@ int main()
 {
     srand(time(0));
 
-    // Inicialização da GLFW
-    glfwInit();
-
-    // Muita atenção aqui: alguns ambientes não aceitam essas configurações
-    // Você deve adaptar para a versão do OpenGL suportada por sua placa
-    // Sugestão: comente essas linhas de código para desobrir a versão e
-    // depois atualize (por exemplo: 4.5 com 4 e 5)
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // Essencial para computadores da Apple
-    // #ifdef __APPLE__
-    //	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    // #endif
-
-    // Criação da janela GLFW
-    GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Jogo das Cores! M3 - Arthur", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
+    // Criação da janela GLFW, já com o contexto OpenGL e a GLAD inicializados
+    GLFWwindow *window = createWindow(WIDTH, HEIGHT, "Jogo das Cores! M3 - Arthur");
+    if (!window)
+    {
+        return -1;
+    }
 
     // Fazendo o registro da função de callback para a janela GLFW
     glfwSetKeyCallback(window, key_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
 
-    // GLAD: carrega todos os ponteiros d funções da OpenGL
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-    }
-
-    // Obtendo as informações de versão
-    const GLubyte *renderer = glGetString(GL_RENDERER); /* get renderer string */
-    const GLubyte *version = glGetString(GL_VERSION);   /* version as a string */
-    cout << "Renderer: " << renderer << endl;
-    cout << "OpenGL version supported " << version << endl;
-
-    // Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-    glViewport(0, 0, width, height);
-
     // Compilando e buildando o programa de shader
-    GLuint shaderID = setupShader();
+    ShaderProgram shader(vertexShaderSource, fragmentShaderSource);
+    // Handles dos uniforms usados dentro do game loop (resolvidos uma única vez)
+    int modelLoc = shader.uniform("model");
 
     GLuint VAO = createSquare();
 
     createGame();
 
-    glUseProgram(shaderID);
+    shader.use();
 
     // Enviando a cor desejada (vec4) para o fragment shader
     // Utilizamos a variáveis do tipo uniform em GLSL para armazenar esse tipo de info
     // que não está nos buffers
-    GLint colorLoc = glGetUniformLocation(shaderID, "inputColor");
+    int colorLoc = shader.uniform("inputColor");
 
     // Matriz de projeção paralela ortográfica
     // mat4 projection = ortho(-10.0, 10.0, -10.0, 10.0, -1.0, 1.0);
     mat4 projection = ortho(0.0, 800.0, 600.0, 0.0, -1.0, 1.0);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+    shader.setMat4(shader.uniform("projection"), projection);
 
     // Loop da aplicação - "game loop"
     while (!glfwWindowShouldClose(window))
     {
+        profiler::beginFrame();
+
         // Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
+        profiler::beginScope("glfwPollEvents");
         glfwPollEvents();
+        profiler::endScope();
+
+        // Atualização e desenho do frame
+        profiler::beginScope("render", true);
 
         // Limpa o buffer de cor
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
+        glstate::clearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
         glClear(GL_COLOR_BUFFER_BIT);
 
-        glLineWidth(10);
-        glPointSize(20);
+        glstate::lineWidth(10);
+        glstate::pointSize(20);
 
-        glBindVertexArray(VAO); // Conectando ao buffer de geometria
+        glstate::bindVertexArray(VAO); // Conectando ao buffer de geometria
 
         if (numberOfEliminated >= ROWS * COLS)
         {
@@ -190,9 +169,9 @@ int main()
 
                     // Escala
                     model = scale(model, square.dimensions);
-                    glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+                    shader.setMat4(modelLoc, model);
 
-                    glUniform4f(colorLoc, square.color.r, square.color.b, square.color.g, 1.0f); // enviando cor para variável uniform inputColor
+                    shader.setVec4(colorLoc, glm::vec4(square.color.r, square.color.b, square.color.g, 1.0f)); // enviando cor para variável uniform inputColor
                     // Chamada de desenho - drawcall
                     // Poligono Preenchido - GL_TRIANGLE_STRIP
                     glDrawArrays(GL_TRIANGLE_STRIP, 0, 6);
@@ -200,13 +179,22 @@ int main()
             }
         }
 
-        glBindVertexArray(0); // Desconectando o buffer de geometria
+        glstate::bindVertexArray(0); // Desconectando o buffer de geometria
+
+        profiler::endScope();
 
         // Troca os buffers da tela
+        profiler::beginScope("glfwSwapBuffers");
         glfwSwapBuffers(window);
+        profiler::endScope();
+
+        profiler::endFrame();
     }
     // Pede pra OpenGL desalocar os buffers
     // glDeleteVertexArrays(1, &VAO);
+
+    profiler::shutdown();
+
     // Finaliza a execução da GLFW, limpando os recursos alocados por ela
     glfwTerminate();
     return 0;
@@ -224,58 +212,6 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
         restartGame();
 }
 
-// Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
-//  shader simples e único neste exemplo de código
-//  O código fonte do vertex e fragment shader está nos arrays vertexShaderSource e
-//  fragmentShader source no iniçio deste arquivo
-//  A função retorna o identificador do programa de shader
-int setupShader()
-{
-    // Vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    // Checando erros de compilação (exibição via log no terminal)
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    // Fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    // Checando erros de compilação (exibição via log no terminal)
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    // Linkando os shaders e criando o identificador do programa de shader
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    // Checando por erros de linkagem
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
-                  << infoLog << std::endl;
-    }
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return shaderProgram;
-}
-
 void mouse_button_callback(GLFWwindow *window, int button, int action, int mods)
 {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
@@ -310,52 +246,6 @@ float calculateDistance(vec3 keyColor, vec3 otherColor)
     return sqrtValue;
 }
 
-GLuint createSquare()
-{
-    GLuint VAO;
-
-    GLfloat vertices[] = {
-        // x    y    z
-        // T0
-        -0.5, 0.5, 0.0,  // v0
-        -0.5, -0.5, 0.0, // v1
-        0.5, 0.5, 0.0,   // v2
-        0.5, -0.5, 0.0,  // v3
-    };
-
-    GLuint VBO;
-    // Geração do identificador do VBO
-    glGenBuffers(1, &VBO);
-    // Faz a conexão (vincula) do buffer como um buffer de array
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // Envia os dados do array de floats para o buffer da OpenGl
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    // Geração do identificador do VAO (Vertex Array Object)
-    glGenVertexArrays(1, &VAO);
-    // Vincula (bind) o VAO primeiro, e em seguida  conecta e seta o(s) buffer(s) de vértices
-    // e os ponteiros para os atributos
-    glBindVertexArray(VAO);
-    // Para cada atributo do vertice, criamos um "AttribPointer" (ponteiro para o atributo), indicando:
-    //  Localização no shader * (a localização dos atributos devem ser correspondentes no layout especificado no vertex shader)
-    //  Numero de valores que o atributo tem (por ex, 3 coordenadas xyz)
-    //  Tipo do dado
-    //  Se está normalizado (entre zero e um)
-    //  Tamanho em bytes
-    //  Deslocamento a partir do byte zero
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid *)0);
-    glEnableVertexAttribArray(0);
-
-    // Observe que isso é permitido, a chamada para glVertexAttribPointer registrou o VBO como o objeto de buffer de vértice
-    // atualmente vinculado - para que depois possamos desvincular com segurança
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
-    glBindVertexArray(0);
-
-    return VAO;
-}
-
 void eliminatesSimilar()
 {
     Square selectedSquare = grid[rowSelected][colSelected];
@@ -419,4 +309,4 @@ void restartGame() {
     cout << "Jogo encerrado!" << endl;
     cout << "Pontuação: " << points << endl;
     createGame();
-}
\ No newline at end of file
+}
@@ -0,0 +1,52 @@
+/* Map cooker
+ *
+ * Converte o texto de autoria de uma fase (assets/maps/<fase>.txt, formato descrito em
+ * common/map_file.h) no arquivo binário que o MapFile mapeia em memória
+ *
+ * Uso: map_cooker <mapa.txt> <arquivo de saída>
+ */
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <map_file.h>
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Uso: " << argv[0] << " <mapa.txt> <arquivo de saída>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "Falha ao abrir " << argv[1] << std::endl;
+        return 1;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+
+    std::vector<unsigned char> binary;
+    if (!mapfile::cook(text.str(), binary, argv[1]))
+    {
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    if (!out)
+    {
+        std::cerr << "Falha ao criar " << argv[2] << std::endl;
+        return 1;
+    }
+    out.write((const char *)binary.data(), binary.size());
+
+    const mapfile::MapHeader *header = (const mapfile::MapHeader *)binary.data();
+    std::cout << argv[2] << " (" << header->width << "x" << header->height << ", " << header->layerCount
+              << " camadas, " << binary.size() << " bytes)" << std::endl;
+    return out.good() ? 0 : 1;
+}
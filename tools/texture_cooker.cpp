@@ -0,0 +1,184 @@
+/* Texture cooker
+ *
+ * Converte todas as imagens (png, jpg, jpeg, bmp) de uma pasta de assets em um
+ * único pacote binário lido pelo TexturePack (common/texture_pack.h): pixels
+ * RGBA8 já decodificados e com a cadeia de mipmaps completa, e o uso do canal
+ * alpha de cada imagem (texture_alpha.h), para o jogo não percorrer os pixels
+ *
+ * Uso: texture_cooker <pasta assets> <arquivo de saída>
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <texture_alpha.h>
+#include <texture_pack.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace fs = std::filesystem;
+
+struct CookedTexture
+{
+    std::string name;
+    uint32_t width, height;
+    AlphaMode alpha;
+    std::vector<std::vector<unsigned char>> levels; // RGBA8, nível 0 primeiro
+};
+
+// Próximo nível da cadeia: média de blocos 2x2 (repetindo a borda em tamanhos ímpares)
+std::vector<unsigned char> downsample(const std::vector<unsigned char> &src, uint32_t w, uint32_t h)
+{
+    uint32_t dw = texpack::levelSize(w, 1), dh = texpack::levelSize(h, 1);
+    std::vector<unsigned char> dst((size_t)dw * dh * 4);
+
+    for (uint32_t y = 0; y < dh; y++)
+    {
+        uint32_t y0 = std::min(y * 2, h - 1), y1 = std::min(y * 2 + 1, h - 1);
+        for (uint32_t x = 0; x < dw; x++)
+        {
+            uint32_t x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+            for (int c = 0; c < 4; c++)
+            {
+                unsigned sum = src[((size_t)y0 * w + x0) * 4 + c] + src[((size_t)y0 * w + x1) * 4 + c] +
+                               src[((size_t)y1 * w + x0) * 4 + c] + src[((size_t)y1 * w + x1) * 4 + c];
+                dst[((size_t)y * dw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+bool isImage(const fs::path &path)
+{
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp";
+}
+
+uint64_t align16(uint64_t offset)
+{
+    return (offset + 15) & ~(uint64_t)15;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        std::cerr << "Uso: " << argv[0] << " <pasta assets> <arquivo de saída>" << std::endl;
+        return 1;
+    }
+
+    fs::path root = argv[1];
+    std::vector<fs::path> files;
+    std::error_code error;
+    for (const fs::directory_entry &entry : fs::recursive_directory_iterator(root, error))
+    {
+        if (entry.is_regular_file() && isImage(entry.path()))
+        {
+            files.push_back(entry.path());
+        }
+    }
+    if (error)
+    {
+        std::cerr << "Falha ao listar " << root << ": " << error.message() << std::endl;
+        return 1;
+    }
+
+    std::vector<CookedTexture> textures;
+    for (const fs::path &file : files)
+    {
+        CookedTexture texture;
+        texture.name = fs::relative(file, root).generic_string();
+        if (texture.name.size() >= texpack::NAME_SIZE)
+        {
+            std::cerr << "Nome muito longo, ignorado: " << texture.name << std::endl;
+            continue;
+        }
+
+        int width, height, nrChannels;
+        unsigned char *pixels = stbi_load(file.string().c_str(), &width, &height, &nrChannels, 4); // sempre RGBA
+        if (!pixels)
+        {
+            std::cerr << "Falha ao decodificar " << file << ": " << stbi_failure_reason() << std::endl;
+            continue;
+        }
+
+        texture.width = width;
+        texture.height = height;
+        texture.alpha = classifyAlpha(pixels, width, height, 4);
+        texture.levels.emplace_back(pixels, pixels + (size_t)width * height * 4);
+        stbi_image_free(pixels);
+
+        uint32_t w = texture.width, h = texture.height;
+        while ((w > 1 || h > 1) && texture.levels.size() < (size_t)texpack::MAX_LEVELS)
+        {
+            texture.levels.push_back(downsample(texture.levels.back(), w, h));
+            w = texpack::levelSize(w, 1);
+            h = texpack::levelSize(h, 1);
+        }
+
+        std::cout << texture.name << " (" << width << "x" << height << ", " << texture.levels.size() << " níveis, "
+                  << alphaModeName(texture.alpha) << ")" << std::endl;
+        textures.push_back(std::move(texture));
+    }
+
+    // Ordem de nome: o TexturePack faz busca binária na tabela
+    std::sort(textures.begin(), textures.end(),
+              [](const CookedTexture &a, const CookedTexture &b) { return a.name < b.name; });
+
+    texpack::PackHeader header;
+    memcpy(header.magic, texpack::MAGIC, 4);
+    header.version = texpack::VERSION;
+    header.count = (uint32_t)textures.size();
+    header.reserved = 0;
+
+    std::vector<texpack::PackEntry> entries(textures.size());
+    uint64_t offset = align16(sizeof(header) + entries.size() * sizeof(texpack::PackEntry));
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        texpack::PackEntry &entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+        strncpy(entry.name, textures[i].name.c_str(), texpack::NAME_SIZE - 1);
+        entry.width = textures[i].width;
+        entry.height = textures[i].height;
+        entry.format = texpack::FORMAT_RGBA8;
+        entry.levels = (uint32_t)textures[i].levels.size();
+        entry.alpha = (uint32_t)textures[i].alpha;
+        for (size_t level = 0; level < textures[i].levels.size(); level++)
+        {
+            entry.levelOffsets[level] = offset;
+            offset = align16(offset + textures[i].levels[level].size());
+        }
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    if (!out)
+    {
+        std::cerr << "Falha ao criar " << argv[2] << std::endl;
+        return 1;
+    }
+    out.write((const char *)&header, sizeof(header));
+    out.write((const char *)entries.data(), entries.size() * sizeof(texpack::PackEntry));
+
+    const char zeros[16] = {};
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        for (size_t level = 0; level < textures[i].levels.size(); level++)
+        {
+            uint64_t position = (uint64_t)out.tellp();
+            out.write(zeros, entries[i].levelOffsets[level] - position); // alinhamento
+            out.write((const char *)textures[i].levels[level].data(), textures[i].levels[level].size());
+        }
+    }
+
+    std::cout << textures.size() << " texturas gravadas em " << argv[2] << std::endl;
+    return out.good() ? 0 : 1;
+}